@@ -50,6 +50,10 @@
          fprintf(stderr, "Formato inválido\n");
          return NULL;
      }
+
+     // Descarta o resto da linha do cabeçalho, para que a primeira linha da grelha seja y = 0
+     int c;
+     while((c = fgetc(fp)) != '\n' && c != EOF);
  
      antena* lista = NULL;
      antena* ultima = NULL;
@@ -130,6 +134,95 @@
      return nefastos;
  }
  
+ /**
+ * @brief Calcula o máximo divisor comum de dois inteiros
+ * @param a Primeiro valor
+ * @param b Segundo valor
+ * @return Máximo divisor comum dos valores absolutos de a e b
+ */
+ int MaximoDivisorComum(int a, int b) {
+     if(a < 0) a = -a;
+     if(b < 0) b = -b;
+     while(b != 0) {
+         int resto = a % b;
+         a = b;
+         b = resto;
+     }
+     return a;
+ }
+ 
+ #define TOTAL_CELULAS (MAX_LINHAS * MAX_COLUNAS)                        ///< Células da grelha
+ #define TOTAL_DIRECOES (MAX_COLUNAS * (2 * MAX_LINHAS - 1))             ///< Direções reduzidas possíveis
+ #define TOTAL_RETAS (TOTAL_DIRECOES * TOTAL_CELULAS)                    ///< Pares (direção, célula inicial)
+ 
+ /**
+ * @brief Calcula os efeitos harmónicos: todas as células das retas entre antenas
+ * @param lista Lista encadeada de antenas a serem analisadas
+ * @return Lista de posições afetadas (ordenada por linha e coluna) ou NULL se nenhuma
+ * @details Para cada par de antenas com mesma frequência, percorre a reta que as
+ *          une até aos limites da grelha, avançando pelo vetor (dx/mdc, dy/mdc).
+ *          Cada reta é identificada pela direção e pela célula onde entra na grelha,
+ *          pelo que só é percorrida uma vez; as células são marcadas num bitset,
+ *          o que elimina repetições sem percorrer a lista de resultados.
+ * @warning A memória alocada deve ser liberada com LibertarEfeitosNefastos()
+ */
+ nefasto* CalcularEfeitosHarmonicos(antena* lista) {
+     unsigned char celulas[(TOTAL_CELULAS + 7) / 8] = { 0 };
+     unsigned char retas[(TOTAL_RETAS + 7) / 8] = { 0 };
+ 
+     for(antena* atual = lista; atual; atual = atual->prox) {
+         if(atual->linha >= MAX_LINHAS || atual->coluna >= MAX_COLUNAS) continue;
+ 
+         for(antena* comparar = atual->prox; comparar; comparar = comparar->prox) {
+             if(atual->frequencia != comparar->frequencia) continue;
+             if(comparar->linha >= MAX_LINHAS || comparar->coluna >= MAX_COLUNAS) continue;
+ 
+             int dx = comparar->coluna - atual->coluna;
+             int dy = comparar->linha - atual->linha;
+             int mdc = MaximoDivisorComum(dx, dy);
+             if(mdc == 0) continue;
+             dx /= mdc;
+             dy /= mdc;
+             if(dx < 0 || (dx == 0 && dy < 0)) {  // Sentido canónico da reta
+                 dx = -dx;
+                 dy = -dy;
+             }
+ 
+             // Recua até à primeira célula da reta dentro da grelha
+             int passos_x = dx > 0 ? atual->coluna / dx : MAX_COLUNAS;
+             int passos_y = dy > 0 ? atual->linha / dy
+                          : dy < 0 ? (MAX_LINHAS - 1 - atual->linha) / -dy : MAX_LINHAS;
+             int passos = passos_x < passos_y ? passos_x : passos_y;
+             int x = atual->coluna - passos * dx;
+             int y = atual->linha - passos * dy;
+ 
+             int reta = (dx * (2 * MAX_LINHAS - 1) + dy + MAX_LINHAS - 1) * TOTAL_CELULAS
+                      + y * MAX_COLUNAS + x;
+             if(retas[reta / 8] & (1 << (reta % 8))) continue;
+             retas[reta / 8] |= (unsigned char)(1 << (reta % 8));
+ 
+             for(; x >= 0 && y >= 0 && x < MAX_COLUNAS && y < MAX_LINHAS; x += dx, y += dy) {
+                 int celula = y * MAX_COLUNAS + x;
+                 celulas[celula / 8] |= (unsigned char)(1 << (celula % 8));
+             }
+         }
+     }
+ 
+     // Percorre o bitset de trás para a frente para a lista ficar por ordem crescente
+     nefasto* harmonicos = NULL;
+     for(int celula = TOTAL_CELULAS - 1; celula >= 0; celula--) {
+         if(!(celulas[celula / 8] & (1 << (celula % 8)))) continue;
+ 
+         nefasto* novo = (nefasto*)malloc(sizeof(nefasto));
+         if(!novo) continue;
+         novo->coluna = celula % MAX_COLUNAS;
+         novo->linha = celula / MAX_COLUNAS;
+         novo->prox = harmonicos;
+         harmonicos = novo;
+     }
+     return harmonicos;
+ }
+ 
  /**
  * @brief Libera a memória alocada para uma lista de antenas
  * @param lista Apontador para o início da lista de antenas
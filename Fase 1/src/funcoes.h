@@ -60,6 +60,13 @@
   */
  nefasto* CalcularEfeitosNefastos(antena* lista);
  
+ /**
+  * @brief Calcula todas as posições nas retas entre antenas da mesma frequência
+  * @param lista Lista de antenas a analisar
+  * @return Lista de efeitos harmónicos, sem repetições, ou NULL se nenhum encontrado
+  */
+ nefasto* CalcularEfeitosHarmonicos(antena* lista);
+ 
  /**
   * @brief Liberta memória de todas as antenas
   * @param lista Lista a ser libertada
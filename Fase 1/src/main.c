@@ -17,12 +17,15 @@
  
      // 2. Calcular os efeitos
      nefasto* efeitos = CalcularEfeitosNefastos(antenas);
+     nefasto* harmonicos = CalcularEfeitosHarmonicos(antenas);
      
      // 3. Escrever os resultados
      FILE *output = fopen("resultado.txt", "w");
      if (!output) {
          printf("Erro ao criar ficheiro de saída!\n");
          LibertarAntenas(antenas);
+         LibertarEfeitosNefastos(efeitos);
+         LibertarEfeitosNefastos(harmonicos);
          return 1;
      }
  
@@ -36,9 +39,15 @@
          fprintf(output, "Posição: (%d,%d)\n", e->coluna, e->linha);
      }
  
+     fprintf(output, "\n=== HARMÓNICOS ===\n");
+     for (nefasto* h = harmonicos; h; h = h->prox) {
+         fprintf(output, "Posição: (%d,%d)\n", h->coluna, h->linha);
+     }
+ 
      // 4. Libertar a memória
      LibertarAntenas(antenas);
      LibertarEfeitosNefastos(efeitos);
+     LibertarEfeitosNefastos(harmonicos);
      fclose(output);
  
      return 0;
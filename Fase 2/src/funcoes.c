@@ -3,7 +3,19 @@
  * @brief Implementação das funções para gestão do grafo de antenas
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "funcoes.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <utime.h>
+#ifdef _WIN32
+#include <direct.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
 
 /**
  * @brief Adiciona uma ligação entre duas antenas
@@ -20,20 +32,62 @@ bool AdicionarAdjacencia(Antena* origem, Antena* destino) {
     
     nova->destino = destino;
     nova->proxima = origem->ligacoes;
+    nova->em_bloco = false;
     origem->ligacoes = nova;
     return true;
 }
 
+/**
+ * @brief Obtém uma ligação livre de uma lista de blocos, criando um bloco se preciso
+ * @param blocos Apontador para o início da lista de blocos (o primeiro é o atual)
+ * @param capacidade Capacidade do bloco a criar se o atual estiver cheio
+ * @return Apontador para a ligação reservada, ou NULL se faltar memória
+ */
+Adjacencia* ReservarLigacao(BlocoLigacoes** blocos, int capacidade) {
+    BlocoLigacoes* bloco = *blocos;
+    if (!bloco || bloco->usadas == bloco->capacidade) {
+        if (capacidade < 1) capacidade = 1;
+        bloco = malloc(sizeof(BlocoLigacoes) + (size_t)capacidade * sizeof(Adjacencia));
+        if (!bloco) return NULL;
+        bloco->usadas = 0;
+        bloco->capacidade = capacidade;
+        bloco->proximo = *blocos;
+        *blocos = bloco;
+    }
+
+    Adjacencia* ligacao = &bloco->ligacoes[bloco->usadas++];
+    ligacao->em_bloco = true;
+    return ligacao;
+}
+
+/**
+ * @brief Obtém o número de threads a usar nas operações paralelas
+ * @return Número de processadores disponíveis, limitado a [1, MAXIMO_TRABALHADORES]
+ */
+int NumeroTrabalhadores(void) {
+    long total;
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    total = (long)info.dwNumberOfProcessors;
+#else
+    total = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (total < 1) return 1;
+    if (total > MAXIMO_TRABALHADORES) return MAXIMO_TRABALHADORES;
+    return (int)total;
+}
+
 /**
  * @brief Adiciona uma nova antena ao grafo
  * @param grafo Apontador para o grafo
- * @param freq Frequência da antena (carácter único)
+ * @param freq Identificador da frequência da antena
  * @param col Posição horizontal (coluna)
  * @param lin Posição vertical (linha)
  * @return true se a antena foi adicionada com sucesso, false caso contrário
  * @note A antena é adicionada no início da lista ligada
  */
-bool AdicionarAntena(Grafo* grafo, char freq, int col, int lin) {
+bool AdicionarAntena(Grafo* grafo, int freq, int col, int lin) {
     if (!grafo) return false;
     
     Antena* nova = malloc(sizeof(Antena));
@@ -44,63 +98,727 @@ bool AdicionarAntena(Grafo* grafo, char freq, int col, int lin) {
     nova->linha = lin;
     nova->ligacoes = NULL;
     nova->visitada = false;
+    nova->indice = grafo->total_antenas;
     nova->proxima = grafo->antenas;
     grafo->antenas = nova;
     grafo->total_antenas++;
     return true;
 }
 
+/**
+ * @brief Calcula a posição inicial de um rótulo na tabela de dispersão
+ * @param rotulo Bytes do rótulo
+ * @param tamanho Número de bytes
+ * @param capacidade Tamanho da tabela (potência de 2)
+ * @return Posição inicial na tabela
+ */
+int PosicaoRotulo(const char* rotulo, size_t tamanho, int capacidade) {
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < tamanho; i++) {
+        hash ^= (unsigned char)rotulo[i];
+        hash *= 16777619u;
+    }
+    return (int)(hash & (unsigned int)(capacidade - 1));
+}
+
+/**
+ * @brief Procura o identificador de uma frequência sem a registar
+ * @param dicionario Apontador para o dicionário
+ * @param rotulo Bytes do rótulo
+ * @param tamanho Número de bytes do rótulo
+ * @return Identificador da frequência, ou -1 se não existir
+ */
+int ProcurarFrequencia(const DicionarioFrequencias* dicionario, const char* rotulo, size_t tamanho) {
+    if (!dicionario || !rotulo || dicionario->capacidade_tabela == 0) return -1;
+
+    int pos = PosicaoRotulo(rotulo, tamanho, dicionario->capacidade_tabela);
+    while (dicionario->tabela[pos] != -1) {
+        const char* existente = dicionario->rotulos[dicionario->tabela[pos]];
+        if (strlen(existente) == tamanho && memcmp(existente, rotulo, tamanho) == 0) {
+            return dicionario->tabela[pos];
+        }
+        pos = (pos + 1) & (dicionario->capacidade_tabela - 1);
+    }
+    return -1;
+}
+
+/**
+ * @brief Obtém o identificador de uma frequência, registando-a se for nova
+ * @param dicionario Apontador para o dicionário
+ * @param rotulo Bytes do rótulo
+ * @param tamanho Número de bytes do rótulo
+ * @return Identificador da frequência, ou -1 se falhar
+ * @note Os identificadores são atribuídos pela ordem de registo, a começar em 0,
+ *       o que permite indexar por frequência tabelas com dicionario->total posições
+ */
+int RegistarFrequencia(DicionarioFrequencias* dicionario, const char* rotulo, size_t tamanho) {
+    if (!dicionario || !rotulo || tamanho == 0 || tamanho > TAMANHO_MAXIMO_ROTULO) return -1;
+
+    int existente = ProcurarFrequencia(dicionario, rotulo, tamanho);
+    if (existente != -1) return existente;
+
+    // Mantém a tabela de dispersão, no máximo, meio cheia
+    if (2 * (dicionario->total + 1) > dicionario->capacidade_tabela) {
+        int capacidade = dicionario->capacidade_tabela ? dicionario->capacidade_tabela * 2 : 64;
+        int* tabela = malloc(capacidade * sizeof(int));
+        if (!tabela) return -1;
+        for (int i = 0; i < capacidade; i++) tabela[i] = -1;
+        for (int id = 0; id < dicionario->total; id++) {
+            const char* r = dicionario->rotulos[id];
+            int pos = PosicaoRotulo(r, strlen(r), capacidade);
+            while (tabela[pos] != -1) pos = (pos + 1) & (capacidade - 1);
+            tabela[pos] = id;
+        }
+        free(dicionario->tabela);
+        dicionario->tabela = tabela;
+        dicionario->capacidade_tabela = capacidade;
+    }
+
+    if (dicionario->total == dicionario->capacidade) {
+        int capacidade = dicionario->capacidade ? dicionario->capacidade * 2 : 16;
+        char** rotulos = realloc(dicionario->rotulos, capacidade * sizeof(char*));
+        if (!rotulos) return -1;
+        dicionario->rotulos = rotulos;
+        dicionario->capacidade = capacidade;
+    }
+
+    char* copia = malloc(tamanho + 1);
+    if (!copia) return -1;
+    memcpy(copia, rotulo, tamanho);
+    copia[tamanho] = '\0';
+
+    int id = dicionario->total++;
+    dicionario->rotulos[id] = copia;
+    int pos = PosicaoRotulo(rotulo, tamanho, dicionario->capacidade_tabela);
+    while (dicionario->tabela[pos] != -1) pos = (pos + 1) & (dicionario->capacidade_tabela - 1);
+    dicionario->tabela[pos] = id;
+    return id;
+}
+
+/**
+ * @brief Obtém o rótulo de uma frequência
+ * @param grafo Apontador para o grafo
+ * @param frequencia Identificador da frequência
+ * @return Rótulo da frequência, ou "?" se o identificador for inválido
+ */
+const char* RotuloFrequencia(const Grafo* grafo, int frequencia) {
+    if (!grafo || frequencia < 0 || frequencia >= grafo->frequencias.total) return "?";
+    return grafo->frequencias.rotulos[frequencia];
+}
+
+/**
+ * @brief Liberta a memória de um dicionário de frequências
+ * @param dicionario Apontador para o dicionário
+ * @return true se a operação foi bem sucedida
+ */
+bool LibertarDicionario(DicionarioFrequencias* dicionario) {
+    if (!dicionario) return false;
+    for (int id = 0; id < dicionario->total; id++) {
+        free(dicionario->rotulos[id]);
+    }
+    free(dicionario->rotulos);
+    free(dicionario->tabela);
+    dicionario->rotulos = NULL;
+    dicionario->total = 0;
+    dicionario->capacidade = 0;
+    dicionario->tabela = NULL;
+    dicionario->capacidade_tabela = 0;
+    return true;
+}
+
+/**
+ * @brief Calcula o número de bytes do carácter UTF-8 que começa em texto
+ * @param texto Início do carácter
+ * @return Número de bytes (1 a 4); sequências inválidas contam como 1 byte
+ */
+int TamanhoCaracterUtf8(const char* texto) {
+    unsigned char c = (unsigned char)texto[0];
+    int tamanho = (c & 0xE0) == 0xC0 ? 2
+                : (c & 0xF0) == 0xE0 ? 3
+                : (c & 0xF8) == 0xF0 ? 4 : 1;
+    for (int i = 1; i < tamanho; i++) {
+        if (((unsigned char)texto[i] & 0xC0) != 0x80) return 1;
+    }
+    return tamanho;
+}
+
+/**
+ * @brief Texto de tamanho variável (linhas lidas, caminhos já formatados)
+ */
+typedef struct TextoDinamico {
+    char* dados;                ///< Conteúdo (não terminado em '\0')
+    size_t tamanho;             ///< Número de bytes usados
+    size_t capacidade;          ///< Número de bytes alocados
+} TextoDinamico;
+
+/**
+ * @brief Acrescenta bytes ao fim de um texto dinâmico
+ * @param texto Apontador para o texto
+ * @param dados Bytes a acrescentar
+ * @param tamanho Número de bytes
+ * @return true se a operação foi bem sucedida
+ */
+bool AcrescentarTexto(TextoDinamico* texto, const char* dados, size_t tamanho) {
+    if (texto->tamanho + tamanho > texto->capacidade) {
+        size_t capacidade = texto->capacidade ? texto->capacidade : 256;
+        while (capacidade < texto->tamanho + tamanho) capacidade *= 2;
+        char* novos = realloc(texto->dados, capacidade);
+        if (!novos) return false;
+        texto->dados = novos;
+        texto->capacidade = capacidade;
+    }
+    memcpy(texto->dados + texto->tamanho, dados, tamanho);
+    texto->tamanho += tamanho;
+    return true;
+}
+
+/**
+ * @brief Lê uma linha inteira de um ficheiro, seja qual for o seu comprimento
+ * @param ficheiro Ficheiro de entrada
+ * @param linha Texto onde fica a linha, terminada em '\0' e sem o '\n' final
+ * @param sem_memoria Posto a true se a linha não coube na memória
+ * @return true se foi lida uma linha, false no fim do ficheiro ou se faltou memória
+ */
+bool LerLinha(FILE* ficheiro, TextoDinamico* linha, bool* sem_memoria) {
+    char pedaco[4096];  // Uma linha longa é lida em vários pedaços
+    bool lida = false;
+    linha->tamanho = 0;
+    *sem_memoria = false;
+
+    while (fgets(pedaco, sizeof(pedaco), ficheiro) != NULL) {
+        lida = true;
+        size_t tamanho = strlen(pedaco);
+        bool completa = tamanho > 0 && pedaco[tamanho - 1] == '\n';
+        if (completa) tamanho--;
+        if (tamanho > 0 && !AcrescentarTexto(linha, pedaco, tamanho)) {
+            *sem_memoria = true;
+            return false;
+        }
+        if (completa) break;
+    }
+    if (!lida) return false;  // Fim do ficheiro
+
+    if (!AcrescentarTexto(linha, "", 1)) {
+        *sem_memoria = true;
+        return false;
+    }
+    linha->tamanho--;  // O '\0' não conta para o tamanho
+    return true;
+}
+
+/**
+ * @brief Lê a grelha de antenas de um ficheiro aberto
+ * @param ficheiro Ficheiro de entrada, posicionado no início
+ * @param registar Função chamada para cada antena encontrada, pela ordem de leitura,
+ *        com o rótulo da frequência (não terminado em '\0') e o seu tamanho
+ * @param contexto Apontador passado a registar
+ * @param linhas Apontador onde é guardado o número de linhas do cabeçalho (pode ser NULL)
+ * @param colunas Apontador onde é guardado o número de colunas do cabeçalho (pode ser NULL)
+ * @return true se o ficheiro foi lido; false se o cabeçalho for inválido ou faltar
+ *         memória para uma linha (as antenas já registadas devem ser descartadas)
+ * @note Cada linha é lida inteira com LerLinha, por isso linhas longas do formato
+ *       estendido nunca são partidas em duas linhas da grelha
+ * @note Formato do ficheiro:
+ *       - Primeira linha: linhas colunas [estendido]
+ *       - Linhas seguintes: matriz de células, onde '.' e ' ' são células vazias
+ *       - No formato normal cada célula é um carácter UTF-8 (ou um byte isolado)
+ *       - No formato estendido as células são tokens separados por espaços,
+ *         com até TAMANHO_MAXIMO_ROTULO bytes, e '.' é uma célula vazia
+ */
+bool LerGrelha(FILE* ficheiro, bool (*registar)(void* contexto, const char* rotulo, size_t tamanho, int col, int lin),
+               void* contexto, int* linhas, int* colunas) {
+    if (!ficheiro || !registar) return false;
+
+    int num_linhas, num_colunas;  // Renomeei para evitar conflito com Antena->linha
+    if (fscanf(ficheiro, "%d %d", &num_linhas, &num_colunas) != 2) {
+        fprintf(stderr, "Formato de ficheiro inválido\n");
+        return false;
+    }
+    if (linhas) *linhas = num_linhas;
+    if (colunas) *colunas = num_colunas;
+
+    TextoDinamico linha = { NULL, 0, 0 };  // Cada linha é lida inteira, mesmo que muito longa
+    bool sem_memoria;
+    if (!LerLinha(ficheiro, &linha, &sem_memoria)) {  // Restante da primeira linha
+        free(linha.dados);
+        if (sem_memoria) fprintf(stderr, "Memória insuficiente para ler o cabeçalho\n");
+        return !sem_memoria;
+    }
+    bool estendido = strstr(linha.dados, MARCADOR_ESTENDIDO) != NULL;
+
+    for (int y = 0; y < num_linhas; y++) {
+        if (!LerLinha(ficheiro, &linha, &sem_memoria)) {
+            if (!sem_memoria) break;  // Fim do ficheiro
+            fprintf(stderr, "Memória insuficiente para ler a linha %d da grelha\n", y);
+            free(linha.dados);
+            return false;
+        }
+        linha.dados[strcspn(linha.dados, "\r")] = '\0';  // Remove o '\r' de ficheiros Windows
+        char* atual = linha.dados;
+
+        for (int x = 0; x < num_colunas && *atual != '\0'; x++) {
+            size_t tamanho;
+            if (estendido) {
+                atual += strspn(atual, " \t");
+                if (*atual == '\0') break;
+                tamanho = strcspn(atual, " \t");
+                if (tamanho > TAMANHO_MAXIMO_ROTULO) {
+                    fprintf(stderr, "Rótulo demasiado longo na linha %d, coluna %d\n", y, x);
+                } else if (!(tamanho == 1 && *atual == '.')) {
+                    registar(contexto, atual, tamanho, x, y);
+                }
+            } else {
+                tamanho = (size_t)TamanhoCaracterUtf8(atual);
+                if (*atual != '.' && *atual != ' ') {
+                    registar(contexto, atual, tamanho, x, y);
+                }
+            }
+            atual += tamanho;
+        }
+    }
+    free(linha.dados);
+    return true;
+}
+
+/**
+ * @brief Regista uma antena lida diretamente no grafo
+ * @param contexto Apontador para o Grafo
+ * @param rotulo Rótulo da frequência da antena
+ * @param tamanho Número de bytes do rótulo
+ * @param col Posição horizontal
+ * @param lin Posição vertical
+ * @return true se a antena foi adicionada
+ */
+bool RegistarNoGrafo(void* contexto, const char* rotulo, size_t tamanho, int col, int lin) {
+    Grafo* grafo = contexto;
+    int freq = RegistarFrequencia(&grafo->frequencias, rotulo, tamanho);
+    if (freq == -1) return false;
+    return AdicionarAntena(grafo, freq, col, lin);
+}
+
+/**
+ * @brief Lê as antenas de um ficheiro, sem construir as ligações
+ * @param nome_ficheiro Nome do ficheiro de entrada
+ * @return Estrutura Grafo com as antenas
+ * @note O formato do ficheiro é descrito em LerGrelha. Basta para CalcularChaveCache
+ *       e para o mapa de calor; as restantes análises precisam de ConstruirLigacoes
+ */
+Grafo LerAntenasDoFicheiro(const char* nome_ficheiro) {
+    Grafo grafo = { NULL, 0, 0, 0, NULL, false, { NULL, 0, 0, NULL, 0 } };
+    
+    if (!nome_ficheiro) return grafo;
+    
+    FILE* ficheiro = fopen(nome_ficheiro, "r");
+    if (!ficheiro) {
+        perror("Erro ao abrir ficheiro");
+        return grafo;
+    }
+
+    bool sucesso = LerGrelha(ficheiro, RegistarNoGrafo, &grafo, &grafo.linhas, &grafo.colunas);
+    fclose(ficheiro);
+    if (!sucesso) LibertarGrafo(&grafo);  // Nunca devolve uma grelha lida só em parte
+    return grafo;
+}
+
 /**
  * @brief Carrega a rede de antenas a partir de um ficheiro
  * @param nome_ficheiro Nome do ficheiro de entrada
  * @return Estrutura Grafo populada
- * @note Formato do ficheiro:
- *       - Primeira linha: linhas colunas
- *       - Linhas seguintes: matriz de caracteres
- *       - Caracteres válidos: qualquer exceto '.' e ' '
+ * @note O formato do ficheiro é descrito em LerGrelha
  */
 Grafo CarregarAntenasDoFicheiro(const char* nome_ficheiro) {
-    Grafo grafo = { NULL, 0 };
+    Grafo grafo = LerAntenasDoFicheiro(nome_ficheiro);
+
+    // Cria as adjacências entre antenas da mesma frequência
+    if (grafo.total_antenas > 0) ConstruirLigacoes(&grafo);
     
+    return grafo;
+}
+
+/**
+ * @brief Posição e frequência de uma antena lida, antes de entrar no grafo
+ */
+typedef struct RegistoAntena {
+    char rotulo[TAMANHO_MAXIMO_ROTULO]; ///< Rótulo da frequência (não terminado em '\0')
+    int tamanho;                ///< Número de bytes do rótulo
+    int coluna;                 ///< Posição horizontal
+    int linha;                  ///< Posição vertical
+} RegistoAntena;
+
+/**
+ * @brief Bloco de antenas lidas, passado do leitor para o construtor do grafo
+ */
+typedef struct BlocoAntenas {
+    RegistoAntena registos[TAMANHO_BLOCO];  ///< Antenas do bloco, pela ordem de leitura
+    int total;                              ///< Número de antenas no bloco
+} BlocoAntenas;
+
+/**
+ * @brief Fila limitada de blocos entre a thread de leitura e a de construção
+ */
+typedef struct FilaBlocos {
+    BlocoAntenas blocos[CAPACIDADE_FILA];   ///< Buffer circular de blocos
+    int inicio;                             ///< Posição do bloco mais antigo
+    int total;                              ///< Número de blocos na fila
+    bool terminada;                         ///< Indica que o leitor já não vai produzir mais blocos
+    bool sucesso;                           ///< Falso se LerGrelha falhou
+    int linhas;                             ///< Número de linhas indicado no cabeçalho
+    int colunas;                            ///< Número de colunas indicado no cabeçalho
+    BlocoAntenas atual;                     ///< Bloco que o leitor está a preencher
+    FILE* ficheiro;                         ///< Ficheiro a ser lido
+    pthread_mutex_t trinco;                 ///< Protege os campos partilhados
+    pthread_cond_t nao_vazia;               ///< Sinalizada quando entra um bloco ou a leitura termina
+    pthread_cond_t nao_cheia;               ///< Sinalizada quando sai um bloco
+} FilaBlocos;
+
+/**
+ * @brief Coloca o bloco atual do leitor na fila, esperando se estiver cheia
+ * @param fila Apontador para a fila
+ */
+void EnviarBloco(FilaBlocos* fila) {
+    if (fila->atual.total == 0) return;
+
+    pthread_mutex_lock(&fila->trinco);
+    while (fila->total == CAPACIDADE_FILA) {
+        pthread_cond_wait(&fila->nao_cheia, &fila->trinco);
+    }
+    fila->blocos[(fila->inicio + fila->total) % CAPACIDADE_FILA] = fila->atual;
+    fila->total++;
+    pthread_cond_signal(&fila->nao_vazia);
+    pthread_mutex_unlock(&fila->trinco);
+
+    fila->atual.total = 0;
+}
+
+/**
+ * @brief Regista uma antena lida no bloco atual, enviando-o quando fica cheio
+ * @param contexto Apontador para a FilaBlocos
+ * @param rotulo Rótulo da frequência da antena
+ * @param tamanho Número de bytes do rótulo
+ * @param col Posição horizontal
+ * @param lin Posição vertical
+ * @return true
+ */
+bool RegistarNaFila(void* contexto, const char* rotulo, size_t tamanho, int col, int lin) {
+    FilaBlocos* fila = contexto;
+    RegistoAntena* registo = &fila->atual.registos[fila->atual.total++];
+    memcpy(registo->rotulo, rotulo, tamanho);
+    registo->tamanho = (int)tamanho;
+    registo->coluna = col;
+    registo->linha = lin;
+    if (fila->atual.total == TAMANHO_BLOCO) EnviarBloco(fila);
+    return true;
+}
+
+/**
+ * @brief Função da thread de leitura do carregamento em pipeline
+ * @param arg Apontador para a FilaBlocos
+ * @return NULL
+ */
+void* LerGrelhaTrabalhador(void* arg) {
+    FilaBlocos* fila = arg;
+    bool sucesso = LerGrelha(fila->ficheiro, RegistarNaFila, fila, &fila->linhas, &fila->colunas);
+    EnviarBloco(fila);
+
+    pthread_mutex_lock(&fila->trinco);
+    fila->sucesso = sucesso;
+    fila->terminada = true;
+    pthread_cond_signal(&fila->nao_vazia);
+    pthread_mutex_unlock(&fila->trinco);
+    return NULL;
+}
+
+/**
+ * @brief Lê a rede de antenas com leitura e inserção no grafo sobrepostas
+ * @param nome_ficheiro Nome do ficheiro de entrada
+ * @return Estrutura Grafo igual à de LerAntenasDoFicheiro (sem ligações)
+ * @note Uma thread lê o ficheiro e envia as antenas em blocos de TAMANHO_BLOCO
+ *       por uma fila limitada a CAPACIDADE_FILA blocos; a thread atual regista as
+ *       frequências e insere as antenas no grafo à medida que chegam. As ligações
+ *       não são criadas aqui: cada grupo só fica completo no fim do ficheiro, e
+ *       ExportarResultadosEmPipeline constrói-as em paralelo com as secções que
+ *       não as usam. Com um só processador não há sobreposição possível e a
+ *       leitura é feita por LerAntenasDoFicheiro.
+ */
+Grafo LerAntenasEmPipeline(const char* nome_ficheiro) {
+    Grafo grafo = { NULL, 0, 0, 0, NULL, false, { NULL, 0, 0, NULL, 0 } };
+
     if (!nome_ficheiro) return grafo;
-    
+    if (NumeroTrabalhadores() == 1) return LerAntenasDoFicheiro(nome_ficheiro);
+
     FILE* ficheiro = fopen(nome_ficheiro, "r");
     if (!ficheiro) {
         perror("Erro ao abrir ficheiro");
         return grafo;
     }
 
-    int num_linhas, num_colunas;  // Renomeei para evitar conflito com Antena->linha
-    if (fscanf(ficheiro, "%d %d", &num_linhas, &num_colunas) != 2) {
+    FilaBlocos* fila = malloc(sizeof(FilaBlocos));
+    if (!fila) {
         fclose(ficheiro);
-        fprintf(stderr, "Formato de ficheiro inválido\n");
         return grafo;
     }
+    fila->inicio = 0;
+    fila->total = 0;
+    fila->terminada = false;
+    fila->sucesso = false;
+    fila->linhas = 0;
+    fila->colunas = 0;
+    fila->atual.total = 0;
+    fila->ficheiro = ficheiro;
+    pthread_mutex_init(&fila->trinco, NULL);
+    pthread_cond_init(&fila->nao_vazia, NULL);
+    pthread_cond_init(&fila->nao_cheia, NULL);
 
-    while (fgetc(ficheiro) != '\n');  // Consome o restante da primeira linha
+    pthread_t leitor;
+    if (pthread_create(&leitor, NULL, LerGrelhaTrabalhador, fila) != 0) {
+        fila->sucesso = LerGrelha(ficheiro, RegistarNoGrafo, &grafo, &fila->linhas, &fila->colunas);  // Sem thread, lê sequencialmente
+    }
+    else {
+        for (;;) {
+            pthread_mutex_lock(&fila->trinco);
+            while (fila->total == 0 && !fila->terminada) {
+                pthread_cond_wait(&fila->nao_vazia, &fila->trinco);
+            }
+            if (fila->total == 0) {
+                pthread_mutex_unlock(&fila->trinco);
+                break;
+            }
+            BlocoAntenas* bloco = &fila->blocos[fila->inicio];
+            pthread_mutex_unlock(&fila->trinco);
 
-    char buffer_linha[1024];  // Buffer para ler cada linha do ficheiro
-    for (int y = 0; y < num_linhas && fgets(buffer_linha, sizeof(buffer_linha), ficheiro) != NULL; y++) {
-        buffer_linha[strcspn(buffer_linha, "\n")] = '\0';  // Remove newline
-        for (int x = 0; x < num_colunas && x < (int)strlen(buffer_linha); x++) {
-            if (buffer_linha[x] != '.' && buffer_linha[x] != ' ') {
-                AdicionarAntena(&grafo, buffer_linha[x], x, y);
+            // O leitor não escreve neste bloco enquanto ele não sair da fila
+            for (int i = 0; i < bloco->total; i++) {
+                RegistarNoGrafo(&grafo, bloco->registos[i].rotulo, (size_t)bloco->registos[i].tamanho,
+                                bloco->registos[i].coluna, bloco->registos[i].linha);
             }
+
+            pthread_mutex_lock(&fila->trinco);
+            fila->inicio = (fila->inicio + 1) % CAPACIDADE_FILA;
+            fila->total--;
+            pthread_cond_signal(&fila->nao_cheia);
+            pthread_mutex_unlock(&fila->trinco);
         }
+        pthread_join(leitor, NULL);
     }
-    
+
+    bool sucesso = fila->sucesso;
+    grafo.linhas = fila->linhas;
+    grafo.colunas = fila->colunas;
+    pthread_mutex_destroy(&fila->trinco);
+    pthread_cond_destroy(&fila->nao_vazia);
+    pthread_cond_destroy(&fila->nao_cheia);
+    free(fila);
     fclose(ficheiro);
 
-    // Cria as adjacências entre antenas da mesma frequência
-    for (Antena* a1 = grafo.antenas; a1 != NULL; a1 = a1->proxima) {
-        for (Antena* a2 = grafo.antenas; a2 != NULL; a2 = a2->proxima) {
-            if (a1 != a2 && a1->frequencia == a2->frequencia) {
-                AdicionarAdjacencia(a1, a2);
+    if (!sucesso) LibertarGrafo(&grafo);  // Nunca devolve uma grelha lida só em parte
+    return grafo;
+}
+
+/**
+ * @brief Agrupa as antenas do grafo por frequência
+ * @param grafo Apontador para o grafo
+ * @param total_grupos Apontador onde é guardado o número de grupos
+ * @return Vetor de grupos indexado pelo identificador da frequência, ou NULL se falhar
+ * @note Há um grupo por frequência do dicionário (grafo->frequencias.total), mesmo
+ *       que vazio, para que grupos[freq] seja o grupo da frequência freq.
+ *       Dentro de cada grupo as antenas mantêm a ordem da lista do grafo
+ */
+GrupoFrequencia* AgruparPorFrequencia(Grafo* grafo, int* total_grupos) {
+    if (!grafo || !total_grupos) return NULL;
+    *total_grupos = 0;
+
+    int total_frequencias = grafo->frequencias.total;
+    if (grafo->total_antenas == 0 || total_frequencias == 0) return NULL;
+
+    GrupoFrequencia* grupos = calloc(total_frequencias, sizeof(GrupoFrequencia));
+    if (!grupos) return NULL;
+
+    for (Antena* a = grafo->antenas; a != NULL; a = a->proxima) {
+        grupos[a->frequencia].total++;
+    }
+
+    for (int f = 0; f < total_frequencias; f++) {
+        grupos[f].frequencia = f;
+        if (grupos[f].total == 0) continue;
+        grupos[f].antenas = malloc(grupos[f].total * sizeof(Antena*));
+        if (!grupos[f].antenas) {
+            LibertarGrupos(grupos, total_frequencias);
+            return NULL;
+        }
+        grupos[f].total = 0;
+    }
+
+    for (Antena* a = grafo->antenas; a != NULL; a = a->proxima) {
+        GrupoFrequencia* grupo = &grupos[a->frequencia];
+        grupo->antenas[grupo->total++] = a;
+    }
+
+    *total_grupos = total_frequencias;
+    return grupos;
+}
+
+/**
+ * @brief Liberta a memória de um vetor de grupos de frequência
+ * @param grupos Vetor de grupos
+ * @param total_grupos Número de grupos no vetor
+ * @return true se a operação foi bem sucedida
+ */
+bool LibertarGrupos(GrupoFrequencia* grupos, int total_grupos) {
+    if (!grupos) return false;
+    for (int g = 0; g < total_grupos; g++) {
+        free(grupos[g].antenas);
+    }
+    free(grupos);
+    return true;
+}
+
+/**
+ * @brief Parte da construção das ligações: um intervalo de antenas de um grupo
+ */
+typedef struct ParteLigacoes {
+    GrupoFrequencia* grupo;     ///< Grupo a que pertencem as antenas
+    int inicio;                 ///< Primeira antena do intervalo (posição no grupo)
+    int fim;                    ///< Uma posição depois da última antena do intervalo
+} ParteLigacoes;
+
+/**
+ * @brief Estado partilhado pelas threads que constroem as ligações
+ */
+typedef struct TarefaLigacoes {
+    Grafo* grafo;               ///< Grafo que recebe os blocos de ligações
+    ParteLigacoes* partes;      ///< Partes a processar
+    int total_partes;           ///< Número de partes
+    int proxima;                ///< Índice da próxima parte por atribuir
+    bool sucesso;               ///< Falso se alguma alocação falhou
+    pthread_mutex_t trinco;     ///< Protege proxima, sucesso e os blocos do grafo
+} TarefaLigacoes;
+
+/**
+ * @brief Função executada por cada thread na construção das ligações
+ * @param arg Apontador para a TarefaLigacoes partilhada
+ * @return NULL
+ * @note Cada parte só altera as listas de ligações das suas antenas, por isso não
+ *       há partilha de escrita. As ligações vêm de blocos próprios da thread, um
+ *       por parte, que só no fim são juntos aos blocos do grafo.
+ */
+void* ConstruirLigacoesTrabalhador(void* arg) {
+    TarefaLigacoes* tarefa = arg;
+    BlocoLigacoes* blocos = NULL;
+    bool sucesso = true;
+
+    for (;;) {
+        pthread_mutex_lock(&tarefa->trinco);
+        int p = tarefa->proxima++;
+        pthread_mutex_unlock(&tarefa->trinco);
+        if (p >= tarefa->total_partes) break;
+
+        ParteLigacoes* parte = &tarefa->partes[p];
+        GrupoFrequencia* grupo = parte->grupo;
+        int capacidade = (parte->fim - parte->inicio) * (grupo->total - 1);
+        // Mesma ordem do ciclo sequencial sobre a lista, logo resultado determinístico
+        for (int i = parte->inicio; i < parte->fim; i++) {
+            Antena* origem = grupo->antenas[i];
+            for (int j = 0; j < grupo->total; j++) {
+                if (i == j) continue;
+                Adjacencia* nova = ReservarLigacao(&blocos, capacidade);
+                if (!nova) {
+                    sucesso = false;
+                    continue;
+                }
+                nova->destino = grupo->antenas[j];
+                nova->proxima = origem->ligacoes;
+                origem->ligacoes = nova;
             }
         }
     }
-    
-    return grafo;
+
+    BlocoLigacoes* ultimo = blocos;
+    while (ultimo && ultimo->proximo) ultimo = ultimo->proximo;
+
+    pthread_mutex_lock(&tarefa->trinco);
+    if (ultimo) {
+        ultimo->proximo = tarefa->grafo->blocos_ligacoes;
+        tarefa->grafo->blocos_ligacoes = blocos;
+    }
+    if (!sucesso) tarefa->sucesso = false;
+    pthread_mutex_unlock(&tarefa->trinco);
+    return NULL;
+}
+
+/**
+ * @brief Cria as ligações entre antenas da mesma frequência
+ * @param grafo Apontador para o grafo
+ * @return true se a operação foi bem sucedida
+ * @note As antenas são agrupadas por frequência e cada grupo é construído numa
+ *       das threads de NumeroTrabalhadores(). Grupos com mais de LIMIAR_DIVISAO_GRUPO
+ *       ligações são divididos em intervalos de antenas, para que um mapa com uma
+ *       só frequência também seja construído em paralelo. As listas de ligações
+ *       ficam iguais às da construção sequencial, independentemente do escalonamento.
+ */
+bool ConstruirLigacoes(Grafo* grafo) {
+    if (!grafo) return false;
+    if (grafo->com_ligacoes) return true;
+
+    int total_grupos = 0;
+    GrupoFrequencia* grupos = AgruparPorFrequencia(grafo, &total_grupos);
+    if (!grupos) {
+        grafo->com_ligacoes = grafo->total_antenas == 0;
+        return grafo->com_ligacoes;
+    }
+
+    int num_threads = NumeroTrabalhadores();
+    int total_partes = 0;
+    for (int g = 0; g < total_grupos; g++) {
+        long long ligacoes = (long long)grupos[g].total * (grupos[g].total - 1);
+        total_partes += ligacoes > LIMIAR_DIVISAO_GRUPO ? num_threads : 1;
+    }
+
+    ParteLigacoes* partes = malloc(total_partes * sizeof(ParteLigacoes));
+    if (!partes) {
+        LibertarGrupos(grupos, total_grupos);
+        return false;
+    }
+
+    int p = 0;
+    for (int g = 0; g < total_grupos; g++) {
+        int k = grupos[g].total;
+        int divisoes = (long long)k * (k - 1) > LIMIAR_DIVISAO_GRUPO ? num_threads : 1;
+        for (int d = 0; d < divisoes; d++) {
+            partes[p].grupo = &grupos[g];
+            partes[p].inicio = (int)((long long)k * d / divisoes);
+            partes[p].fim = (int)((long long)k * (d + 1) / divisoes);
+            if (partes[p].inicio < partes[p].fim) p++;
+        }
+    }
+    total_partes = p;
+
+    TarefaLigacoes tarefa;
+    tarefa.grafo = grafo;
+    tarefa.partes = partes;
+    tarefa.total_partes = total_partes;
+    tarefa.proxima = 0;
+    tarefa.sucesso = true;
+    pthread_mutex_init(&tarefa.trinco, NULL);
+
+    if (num_threads > total_partes) num_threads = total_partes;
+    pthread_t threads[MAXIMO_TRABALHADORES];
+    int criadas = 0;
+    for (int t = 1; t < num_threads; t++) {
+        if (pthread_create(&threads[criadas], NULL, ConstruirLigacoesTrabalhador, &tarefa) != 0) break;
+        criadas++;
+    }
+
+    ConstruirLigacoesTrabalhador(&tarefa);  // A thread atual também participa
+
+    for (int t = 0; t < criadas; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    pthread_mutex_destroy(&tarefa.trinco);
+    free(partes);
+    LibertarGrupos(grupos, total_grupos);
+    grafo->com_ligacoes = tarefa.sucesso;
+    return tarefa.sucesso;
 }
 
 /**
@@ -115,7 +833,7 @@ bool ProcuraEmProfundidade(Grafo* grafo, Antena* atual, FILE* saida) {
     if (atual->visitada) return true;
     
     atual->visitada = true;
-    fprintf(saida, "Antena %c @ (%d,%d)\n", atual->frequencia, atual->coluna, atual->linha);
+    fprintf(saida, "Antena %s @ (%d,%d)\n", RotuloFrequencia(grafo, atual->frequencia), atual->coluna, atual->linha);
 
     for (Adjacencia* adj = atual->ligacoes; adj != NULL; adj = adj->proxima) {
         ProcuraEmProfundidade(grafo, adj->destino, saida);
@@ -151,7 +869,7 @@ bool ProcuraEmLargura(Grafo* grafo, Antena* inicio, FILE* saida) {
         frente = frente->proxima;
         free(temp);
         
-        fprintf(saida, "Antena %c @ (%d,%d)\n", atual->frequencia, atual->coluna, atual->linha);
+        fprintf(saida, "Antena %s @ (%d,%d)\n", RotuloFrequencia(grafo, atual->frequencia), atual->coluna, atual->linha);
         
         for (Adjacencia* adj = atual->ligacoes; adj != NULL; adj = adj->proxima) {
             if (!adj->destino->visitada) {
@@ -172,20 +890,21 @@ bool ProcuraEmLargura(Grafo* grafo, Antena* inicio, FILE* saida) {
 
 /**
  * @brief Função auxiliar para imprimir um caminho
+ * @param grafo Apontador para o grafo
  * @param caminho Apontador para o início do caminho
  * @param saida Ficheiro de saída
  * @note Função recursiva que imprime do fim para o início
  */
-bool ImprimirCaminho(CaminhoNode* caminho, FILE* saida) {
+bool ImprimirCaminho(Grafo* grafo, CaminhoNode* caminho, FILE* saida) {
     if (!caminho) return false;
 
-    ImprimirCaminho(caminho->proxima, saida);  // chamada recursiva sem guardar retorno
+    ImprimirCaminho(grafo, caminho->proxima, saida);  // chamada recursiva sem guardar retorno
 
-    fprintf(saida, "%c(%d,%d)", caminho->antena->frequencia,
-                                caminho->antena->coluna,
-                                caminho->antena->linha);
     if (caminho->proxima)
         fprintf(saida, " -> ");
+    fprintf(saida, "%s(%d,%d)", RotuloFrequencia(grafo, caminho->antena->frequencia),
+                                caminho->antena->coluna,
+                                caminho->antena->linha);
 
     return true;
 }
@@ -210,7 +929,7 @@ bool EncontrarCaminhosRec(Grafo* grafo, Antena* atual, Antena* destino, CaminhoN
     atual->visitada = true;
     
     if (atual == destino) {
-        ImprimirCaminho(caminho, saida);
+        ImprimirCaminho(grafo, caminho, saida);
         fprintf(saida, "\n");
     } else {
         for (Adjacencia* adj = atual->ligacoes; adj != NULL; adj = adj->proxima) {
@@ -240,66 +959,1087 @@ bool EncontrarCaminhos(Grafo* grafo, Antena* origem, Antena* destino, FILE* said
 }
 
 /**
- * @brief Mostra intersecções entre antenas de frequências diferentes
- * @param grafo Apontador para o grafo
- * @param freqA Primeira frequência
- * @param freqB Segunda frequência
- * @param saida Ficheiro de saída
- * @return true se a operação foi bem sucedida
+ * @brief Subárvore da procura de caminhos, identificada pelo prefixo que a origina
  */
-bool MostrarIntersecoes(Grafo* grafo, char freqA, char freqB, FILE* saida) {
-    if (!grafo || !saida) return false;
-    
-    for (Antena* a = grafo->antenas; a != NULL; a = a->proxima) {
-        if (a->frequencia == freqA) {
-            for (Antena* b = grafo->antenas; b != NULL; b = b->proxima) {
-                if (b->frequencia == freqB && 
-                    (a->linha == b->linha || a->coluna == b->coluna)) {
-                    fprintf(saida, "%c(%d,%d) - %c(%d,%d)\n",
-                           freqA, a->coluna, a->linha,
-                           freqB, b->coluna, b->linha);
-                }
-            }
-        }
-    }
-    return true;
-}
+typedef struct TarefaCaminhos {
+    int* prefixo;               ///< Índices das antenas do prefixo, a começar na origem
+    int comprimento;            ///< Número de antenas no prefixo
+    long long encontrados;      ///< Caminhos encontrados nesta subárvore
+    TextoDinamico texto;        ///< Caminhos formatados ainda não escritos (só linhas completas)
+    size_t contabilizados;      ///< Bytes de texto já somados a EnumeracaoCaminhos::pendentes
+    bool guardar_texto;         ///< Cópia de trabalho da thread: falso depois de uma interrupção
+    bool concluida;             ///< Indica que a subárvore já foi toda percorrida
+} TarefaCaminhos;
 
 /**
- * @brief Calcula pontos de interferência entre antenas
- * @param grafo Apontador para o grafo
- * @param saida Ficheiro de saída
- * @return true se a operação foi bem sucedida
+ * @brief Fila de tarefas de uma thread; o dono tira do início, os ladrões do fim
  */
-bool CalcularInterferencias(Grafo* grafo, FILE* saida) {
-    if (!grafo || !saida) return false;
+typedef struct FilaTarefas {
+    int inicio;                 ///< Próxima tarefa a tirar pelo dono
+    int fim;                    ///< Uma posição depois da última tarefa
+    pthread_mutex_t trinco;     ///< Protege inicio e fim
+} FilaTarefas;
+
+/**
+ * @brief Estado partilhado pela enumeração paralela de caminhos
+ */
+typedef struct EnumeracaoCaminhos {
+    Grafo* grafo;               ///< Grafo analisado
+    Antena** antenas;           ///< Antenas do grafo indexadas por Antena::indice
+    int total_antenas;          ///< Número de antenas do grafo
+    Antena* destino;            ///< Antena de destino
+    bool guardar_texto;         ///< Se falso, os caminhos são só contados
+    TarefaCaminhos* tarefas;    ///< Tarefas, pela ordem da procura sequencial
+    int total_tarefas;          ///< Número de tarefas
+    int capacidade_tarefas;     ///< Número de tarefas alocadas
+    int num_trabalhadores;      ///< Número de threads (e de filas)
+    FilaTarefas filas[MAXIMO_TRABALHADORES]; ///< Fila de tarefas de cada thread
+    FILE* saida;                ///< Ficheiro de saída (NULL se só se contam caminhos)
+    int proxima_escrita;        ///< Primeira tarefa por concluir e escrever (total_tarefas quando todas correram)
+    size_t pendentes;           ///< Bytes guardados por tarefas que ainda não podem ser escritas
+    bool interrompida;          ///< Indica que a listagem parou e os caminhos só são contados
+    bool sucesso_escrita;       ///< Falso se uma escrita no ficheiro falhou
+    pthread_mutex_t trinco_escrita; ///< Protege os campos de escrita e os textos das tarefas concluídas
+} EnumeracaoCaminhos;
+
+/**
+ * @brief Argumento de cada thread da enumeração paralela
+ */
+typedef struct TrabalhadorCaminhos {
+    EnumeracaoCaminhos* enumeracao; ///< Estado partilhado
+    int id;                         ///< Índice da fila própria
+} TrabalhadorCaminhos;
+
+/**
+ * @brief Cria as tarefas percorrendo a árvore de caminhos até uma profundidade
+ * @param enumeracao Estado da enumeração
+ * @param caminho Prefixo atual (índices)
+ * @param comprimento Número de antenas no prefixo
+ * @param visitadas Bitset das antenas no prefixo
+ * @param profundidade Número de ligações a partir das quais o prefixo vira tarefa
+ * @return true se a operação foi bem sucedida
+ * @note As tarefas ficam pela mesma ordem em que EncontrarCaminhosRec as visitaria
+ */
+bool GerarTarefasCaminhos(EnumeracaoCaminhos* enumeracao, int* caminho, int comprimento,
+                          unsigned char* visitadas, int profundidade) {
+    Antena* atual = enumeracao->antenas[caminho[comprimento - 1]];
+
+    if (atual == enumeracao->destino || comprimento > profundidade) {
+        if (enumeracao->total_tarefas == enumeracao->capacidade_tarefas) {
+            int capacidade = enumeracao->capacidade_tarefas ? enumeracao->capacidade_tarefas * 2 : 64;
+            TarefaCaminhos* novas = realloc(enumeracao->tarefas, capacidade * sizeof(TarefaCaminhos));
+            if (!novas) return false;
+            enumeracao->tarefas = novas;
+            enumeracao->capacidade_tarefas = capacidade;
+        }
+        TarefaCaminhos* tarefa = &enumeracao->tarefas[enumeracao->total_tarefas];
+        tarefa->prefixo = malloc(comprimento * sizeof(int));
+        if (!tarefa->prefixo) return false;
+        memcpy(tarefa->prefixo, caminho, comprimento * sizeof(int));
+        tarefa->comprimento = comprimento;
+        tarefa->encontrados = 0;
+        tarefa->texto.dados = NULL;
+        tarefa->texto.tamanho = 0;
+        tarefa->texto.capacidade = 0;
+        tarefa->contabilizados = 0;
+        tarefa->guardar_texto = enumeracao->guardar_texto;
+        tarefa->concluida = false;
+        enumeracao->total_tarefas++;
+        return true;
+    }
+
+    for (Adjacencia* adj = atual->ligacoes; adj != NULL; adj = adj->proxima) {
+        int i = adj->destino->indice;
+        if (visitadas[i / 8] & (1 << (i % 8))) continue;
+
+        visitadas[i / 8] |= (unsigned char)(1 << (i % 8));
+        caminho[comprimento] = i;
+        bool sucesso = GerarTarefasCaminhos(enumeracao, caminho, comprimento + 1, visitadas, profundidade);
+        visitadas[i / 8] &= (unsigned char)~(1 << (i % 8));
+        if (!sucesso) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Descarta o texto de uma tarefa, descontando-o dos bytes pendentes
+ * @param enumeracao Estado da enumeração (com trinco_escrita fechado)
+ * @param tarefa Tarefa cujo texto é descartado
+ */
+void DescartarTextoCaminhos(EnumeracaoCaminhos* enumeracao, TarefaCaminhos* tarefa) {
+    enumeracao->pendentes -= tarefa->contabilizados;
+    free(tarefa->texto.dados);
+    tarefa->texto.dados = NULL;
+    tarefa->texto.tamanho = 0;
+    tarefa->texto.capacidade = 0;
+    tarefa->contabilizados = 0;
+}
+
+/**
+ * @brief Interrompe a listagem: liberta os textos guardados e passa a só contar
+ * @param enumeracao Estado da enumeração (com trinco_escrita fechado)
+ * @note Os textos de tarefas ainda em curso são descartados pelas suas threads
+ *       na entrega seguinte, porque só elas lhes podem mexer
+ */
+void InterromperListagemCaminhos(EnumeracaoCaminhos* enumeracao) {
+    if (enumeracao->interrompida) return;
+    enumeracao->interrompida = true;
+    for (int t = enumeracao->proxima_escrita; t < enumeracao->total_tarefas; t++) {
+        if (enumeracao->tarefas[t].concluida) DescartarTextoCaminhos(enumeracao, &enumeracao->tarefas[t]);
+    }
+}
+
+/**
+ * @brief Escreve o texto de uma tarefa no ficheiro de saída e liberta-o
+ * @param enumeracao Estado da enumeração (com trinco_escrita fechado)
+ * @param tarefa Tarefa cujo texto é escrito
+ */
+void EscreverTextoCaminhos(EnumeracaoCaminhos* enumeracao, TarefaCaminhos* tarefa) {
+    if (tarefa->texto.tamanho > 0 &&
+        fwrite(tarefa->texto.dados, 1, tarefa->texto.tamanho, enumeracao->saida) != tarefa->texto.tamanho) {
+        enumeracao->sucesso_escrita = false;
+        InterromperListagemCaminhos(enumeracao);
+    }
+    DescartarTextoCaminhos(enumeracao, tarefa);
+}
+
+/**
+ * @brief Entrega o texto acumulado por uma tarefa para ser escrito por ordem
+ * @param enumeracao Estado da enumeração
+ * @param t Índice da tarefa
+ * @param concluida Indica que a tarefa terminou
+ * @note Se a tarefa é a primeira por escrever, o texto vai logo para o ficheiro;
+ *       se não, fica guardado até chegar a sua vez. Quando uma tarefa termina, as
+ *       tarefas concluídas que a seguem são escritas. Se os bytes guardados
+ *       excederem LIMITE_MEMORIA_CAMINHOS, a listagem é interrompida.
+ */
+void EntregarTextoCaminhos(EnumeracaoCaminhos* enumeracao, int t, bool concluida) {
+    TarefaCaminhos* tarefa = &enumeracao->tarefas[t];
+
+    pthread_mutex_lock(&enumeracao->trinco_escrita);
+    if (enumeracao->interrompida) {
+        DescartarTextoCaminhos(enumeracao, tarefa);
+        tarefa->guardar_texto = false;
+    } else if (t == enumeracao->proxima_escrita) {
+        EscreverTextoCaminhos(enumeracao, tarefa);
+    } else {
+        enumeracao->pendentes += tarefa->texto.tamanho - tarefa->contabilizados;
+        tarefa->contabilizados = tarefa->texto.tamanho;
+        if (enumeracao->pendentes > (size_t)LIMITE_MEMORIA_CAMINHOS) {
+            InterromperListagemCaminhos(enumeracao);
+            DescartarTextoCaminhos(enumeracao, tarefa);
+            tarefa->guardar_texto = false;
+        }
+    }
+
+    if (concluida) {
+        tarefa->concluida = true;
+        while (enumeracao->proxima_escrita < enumeracao->total_tarefas &&
+               enumeracao->tarefas[enumeracao->proxima_escrita].concluida) {
+            TarefaCaminhos* seguinte = &enumeracao->tarefas[enumeracao->proxima_escrita];
+            if (enumeracao->interrompida) DescartarTextoCaminhos(enumeracao, seguinte);
+            else EscreverTextoCaminhos(enumeracao, seguinte);
+            enumeracao->proxima_escrita++;
+        }
+    }
+    pthread_mutex_unlock(&enumeracao->trinco_escrita);
+}
+
+/**
+ * @brief Percorre em profundidade a subárvore de uma tarefa
+ * @param enumeracao Estado da enumeração
+ * @param t Índice da tarefa a que pertencem os caminhos encontrados
+ * @param caminho Pilha do caminho atual (índices), própria da tarefa
+ * @param comprimento Número de antenas no caminho
+ * @param visitadas Bitset das antenas no caminho, próprio da tarefa
+ * @param linha Texto de trabalho da thread, onde cada caminho é formatado
+ * @note Cada caminho só entra no texto da tarefa depois de formatado por inteiro
+ */
+void EnumerarCaminhosRec(EnumeracaoCaminhos* enumeracao, int t, int* caminho,
+                         int comprimento, unsigned char* visitadas, TextoDinamico* linha) {
+    Antena* atual = enumeracao->antenas[caminho[comprimento - 1]];
+
+    if (atual == enumeracao->destino) {
+        TarefaCaminhos* tarefa = &enumeracao->tarefas[t];
+        tarefa->encontrados++;
+        if (!tarefa->guardar_texto) return;
+
+        bool formatado = true;
+        char no[TAMANHO_MAXIMO_ROTULO + 64];
+        linha->tamanho = 0;
+        for (int k = 0; k < comprimento && formatado; k++) {
+            Antena* a = enumeracao->antenas[caminho[k]];
+            int n = snprintf(no, sizeof(no), "%s%s(%d,%d)", k > 0 ? " -> " : "",
+                             RotuloFrequencia(enumeracao->grafo, a->frequencia), a->coluna, a->linha);
+            formatado = AcrescentarTexto(linha, no, (size_t)n);
+        }
+        if (formatado) formatado = AcrescentarTexto(linha, "\n", 1);
+        if (formatado) formatado = AcrescentarTexto(&tarefa->texto, linha->dados, linha->tamanho);
+
+        if (!formatado) {  // Sem memória: interrompe a listagem em vez de escrever caminhos incompletos
+            pthread_mutex_lock(&enumeracao->trinco_escrita);
+            InterromperListagemCaminhos(enumeracao);
+            pthread_mutex_unlock(&enumeracao->trinco_escrita);
+            EntregarTextoCaminhos(enumeracao, t, false);
+        } else if (tarefa->texto.tamanho >= BLOCO_TEXTO_CAMINHOS) {
+            EntregarTextoCaminhos(enumeracao, t, false);
+        }
+        return;
+    }
+
+    for (Adjacencia* adj = atual->ligacoes; adj != NULL; adj = adj->proxima) {
+        int i = adj->destino->indice;
+        if (visitadas[i / 8] & (1 << (i % 8))) continue;
+
+        visitadas[i / 8] |= (unsigned char)(1 << (i % 8));
+        caminho[comprimento] = i;
+        EnumerarCaminhosRec(enumeracao, t, caminho, comprimento + 1, visitadas, linha);
+        visitadas[i / 8] &= (unsigned char)~(1 << (i % 8));
+    }
+}
+
+/**
+ * @brief Tira a próxima tarefa da fila própria ou, se vazia, rouba do fim de outra
+ * @param enumeracao Estado da enumeração
+ * @param id Índice da fila própria
+ * @return Índice da tarefa, ou -1 se já não há tarefas
+ */
+int ObterTarefaCaminhos(EnumeracaoCaminhos* enumeracao, int id) {
+    for (int k = 0; k < enumeracao->num_trabalhadores; k++) {
+        FilaTarefas* fila = &enumeracao->filas[(id + k) % enumeracao->num_trabalhadores];
+        int tarefa = -1;
+        pthread_mutex_lock(&fila->trinco);
+        if (fila->inicio < fila->fim) {
+            tarefa = k == 0 ? fila->inicio++ : --fila->fim;
+        }
+        pthread_mutex_unlock(&fila->trinco);
+        if (tarefa >= 0) return tarefa;
+    }
+    return -1;
+}
+
+/**
+ * @brief Função executada por cada thread da enumeração paralela
+ * @param arg Apontador para o TrabalhadorCaminhos
+ * @return NULL
+ */
+void* EnumerarCaminhosTrabalhador(void* arg) {
+    TrabalhadorCaminhos* trabalhador = arg;
+    EnumeracaoCaminhos* enumeracao = trabalhador->enumeracao;
+    int n = enumeracao->total_antenas;
+
+    int* caminho = malloc(n * sizeof(int));
+    unsigned char* visitadas = malloc((n + 7) / 8);
+    if (!caminho || !visitadas) {
+        free(caminho);
+        free(visitadas);
+        return NULL;  // As tarefas ficam para as restantes threads (ver proxima_escrita)
+    }
+
+    TextoDinamico linha = { NULL, 0, 0 };
+    int t;
+    while ((t = ObterTarefaCaminhos(enumeracao, trabalhador->id)) >= 0) {
+        TarefaCaminhos* tarefa = &enumeracao->tarefas[t];
+        memset(visitadas, 0, (n + 7) / 8);
+        for (int k = 0; k < tarefa->comprimento; k++) {
+            caminho[k] = tarefa->prefixo[k];
+            visitadas[caminho[k] / 8] |= (unsigned char)(1 << (caminho[k] % 8));
+        }
+        EnumerarCaminhosRec(enumeracao, t, caminho, tarefa->comprimento, visitadas, &linha);
+        EntregarTextoCaminhos(enumeracao, t, true);
+    }
+
+    free(linha.dados);
+    free(caminho);
+    free(visitadas);
+    return NULL;
+}
+
+/**
+ * @brief Liberta as tarefas de uma enumeração
+ * @param enumeracao Estado da enumeração
+ */
+void LibertarTarefasCaminhos(EnumeracaoCaminhos* enumeracao) {
+    for (int t = 0; t < enumeracao->total_tarefas; t++) {
+        free(enumeracao->tarefas[t].prefixo);
+        free(enumeracao->tarefas[t].texto.dados);
+    }
+    free(enumeracao->tarefas);
+    enumeracao->tarefas = NULL;
+    enumeracao->total_tarefas = 0;
+    enumeracao->capacidade_tarefas = 0;
+}
+
+/**
+ * @brief Encontra todos os caminhos entre duas antenas, em paralelo
+ * @param grafo Apontador para o grafo
+ * @param origem Antena de origem
+ * @param destino Antena de destino
+ * @param saida Ficheiro de saída, ou NULL para apenas contar
+ * @param total_caminhos Número total de caminhos encontrados (opcional)
+ * @return true se a operação foi bem sucedida
+ * @note A árvore de procura é cortada à menor profundidade que dê pelo menos
+ *       TAREFAS_POR_TRABALHADOR tarefas por thread. As tarefas são distribuídas em
+ *       blocos contíguos pelas filas das threads; quem esvazia a sua rouba do fim
+ *       das outras. Cada tarefa tem o seu bitset de visitadas e a sua pilha, pelo
+ *       que os marcadores visitada do grafo não são usados. Os caminhos são
+ *       escritos pela ordem da procura, igual à de EncontrarCaminhos, à medida que
+ *       as tarefas anteriores terminam; só o texto de tarefas que ainda não podem
+ *       ser escritas fica em memória, até LIMITE_MEMORIA_CAMINHOS. Acima disso a
+ *       listagem é interrompida numa linha completa, assinalada no ficheiro, e os
+ *       caminhos restantes só são contados.
+ */
+bool EncontrarCaminhosParalelo(Grafo* grafo, Antena* origem, Antena* destino, FILE* saida, long long* total_caminhos) {
+    if (total_caminhos) *total_caminhos = 0;
+    if (!grafo || !origem || !destino || grafo->total_antenas == 0) return false;
+
+    int n = grafo->total_antenas;
+    EnumeracaoCaminhos enumeracao;
+    enumeracao.grafo = grafo;
+    enumeracao.num_trabalhadores = NumeroTrabalhadores();
+    enumeracao.antenas = malloc(n * sizeof(Antena*));
+    enumeracao.total_antenas = n;
+    enumeracao.destino = destino;
+    enumeracao.guardar_texto = saida != NULL;
+    enumeracao.tarefas = NULL;
+    enumeracao.total_tarefas = 0;
+    enumeracao.capacidade_tarefas = 0;
+    enumeracao.saida = saida;
+    enumeracao.proxima_escrita = 0;
+    enumeracao.pendentes = 0;
+    enumeracao.interrompida = false;
+    enumeracao.sucesso_escrita = true;
+
+    int* caminho = malloc(n * sizeof(int));
+    unsigned char* visitadas = calloc((n + 7) / 8, 1);
+    if (!enumeracao.antenas || !caminho || !visitadas) {
+        free(enumeracao.antenas);
+        free(caminho);
+        free(visitadas);
+        return false;
+    }
+    for (Antena* a = grafo->antenas; a != NULL; a = a->proxima) {
+        enumeracao.antenas[a->indice] = a;
+    }
+
+    // Aprofunda a divisão até haver tarefas suficientes para equilibrar a carga
+    caminho[0] = origem->indice;
+    visitadas[origem->indice / 8] |= (unsigned char)(1 << (origem->indice % 8));
+    bool sucesso = true;
+    int anterior = -1;
+    for (int profundidade = 1; profundidade <= PROFUNDIDADE_MAXIMA_DIVISAO; profundidade++) {
+        LibertarTarefasCaminhos(&enumeracao);
+        sucesso = GerarTarefasCaminhos(&enumeracao, caminho, 1, visitadas, profundidade);
+        if (!sucesso || enumeracao.total_tarefas >= TAREFAS_POR_TRABALHADOR * enumeracao.num_trabalhadores
+            || enumeracao.total_tarefas == anterior) break;
+        anterior = enumeracao.total_tarefas;
+    }
+    free(caminho);
+    free(visitadas);
+
+    if (sucesso) {
+        int num_trabalhadores = enumeracao.num_trabalhadores;
+        TrabalhadorCaminhos trabalhadores[MAXIMO_TRABALHADORES];
+        for (int w = 0; w < num_trabalhadores; w++) {
+            FilaTarefas* fila = &enumeracao.filas[w];
+            fila->inicio = (int)((long long)enumeracao.total_tarefas * w / num_trabalhadores);
+            fila->fim = (int)((long long)enumeracao.total_tarefas * (w + 1) / num_trabalhadores);
+            pthread_mutex_init(&fila->trinco, NULL);
+            trabalhadores[w].enumeracao = &enumeracao;
+            trabalhadores[w].id = w;
+        }
+
+        pthread_mutex_init(&enumeracao.trinco_escrita, NULL);
+
+        pthread_t threads[MAXIMO_TRABALHADORES];
+        bool criada[MAXIMO_TRABALHADORES] = { false };
+        for (int w = 1; w < num_trabalhadores; w++) {
+            criada[w] = pthread_create(&threads[w], NULL, EnumerarCaminhosTrabalhador, &trabalhadores[w]) == 0;
+        }
+
+        EnumerarCaminhosTrabalhador(&trabalhadores[0]);  // A thread atual também participa
+
+        for (int w = 1; w < num_trabalhadores; w++) {
+            if (criada[w]) pthread_join(threads[w], NULL);
+        }
+        for (int w = 0; w < num_trabalhadores; w++) {
+            pthread_mutex_destroy(&enumeracao.filas[w].trinco);
+        }
+        pthread_mutex_destroy(&enumeracao.trinco_escrita);
+
+        long long encontrados = 0;
+        for (int t = 0; t < enumeracao.total_tarefas; t++) {
+            encontrados += enumeracao.tarefas[t].encontrados;
+        }
+        if (total_caminhos) *total_caminhos = encontrados;
+
+        // Se nenhuma thread conseguiu memória para uma tarefa, ela nunca chegou a correr
+        // e a listagem (ou a contagem) está incompleta
+        if (enumeracao.proxima_escrita != enumeracao.total_tarefas) {
+            fprintf(stderr, "Erro: %d tarefas da procura de caminhos não foram executadas\n",
+                    enumeracao.total_tarefas - enumeracao.proxima_escrita);
+            sucesso = false;
+        }
+        else if (!enumeracao.sucesso_escrita) sucesso = false;
+        else if (saida && enumeracao.interrompida) {
+            fprintf(stderr, "Aviso: listagem de caminhos interrompida por falta de memória\n");
+            fprintf(saida, "... listagem interrompida: %lld caminhos no total\n", encontrados);
+        }
+    }
+
+    LibertarTarefasCaminhos(&enumeracao);
+    free(enumeracao.antenas);
+    return sucesso;
+}
+
+/**
+ * @brief Escreve as intersecções entre as antenas de dois grupos de frequência
+ * @param grafo Apontador para o grafo
+ * @param grupoA Grupo da primeira frequência
+ * @param grupoB Grupo da segunda frequência
+ * @param saida Ficheiro de saída
+ */
+void EscreverIntersecoesGrupos(Grafo* grafo, const GrupoFrequencia* grupoA,
+                               const GrupoFrequencia* grupoB, FILE* saida) {
+    const char* rotuloA = RotuloFrequencia(grafo, grupoA->frequencia);
+    const char* rotuloB = RotuloFrequencia(grafo, grupoB->frequencia);
+
+    for (int i = 0; i < grupoA->total; i++) {
+        Antena* a = grupoA->antenas[i];
+        for (int j = 0; j < grupoB->total; j++) {
+            Antena* b = grupoB->antenas[j];
+            if (a->linha == b->linha || a->coluna == b->coluna) {
+                fprintf(saida, "%s(%d,%d) - %s(%d,%d)\n",
+                       rotuloA, a->coluna, a->linha, rotuloB, b->coluna, b->linha);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Mostra intersecções entre antenas de frequências diferentes
+ * @param grafo Apontador para o grafo
+ * @param freqA Primeira frequência
+ * @param freqB Segunda frequência
+ * @param saida Ficheiro de saída
+ * @return true se a operação foi bem sucedida
+ * @note Só compara as antenas das duas frequências, obtidas com AgruparPorFrequencia
+ */
+bool MostrarIntersecoes(Grafo* grafo, int freqA, int freqB, FILE* saida) {
+    if (!grafo || !saida) return false;
+
+    int total_grupos = 0;
+    GrupoFrequencia* grupos = AgruparPorFrequencia(grafo, &total_grupos);
+    if (!grupos) return grafo->total_antenas == 0;
+
+    if (freqA >= 0 && freqA < total_grupos && freqB >= 0 && freqB < total_grupos) {
+        EscreverIntersecoesGrupos(grafo, &grupos[freqA], &grupos[freqB], saida);
+    }
+    LibertarGrupos(grupos, total_grupos);
+    return true;
+}
+
+/**
+ * @brief Percorre os pontos de interferência entre antenas da mesma frequência
+ * @param grafo Apontador para o grafo
+ * @param pares_distintos Se verdadeiro, visita cada par de antenas distintas uma só
+ *        vez; se falso, visita todos os pares ordenados, incluindo (a, a)
+ * @param visitar Função chamada para cada ponto, com a frequência e a posição
+ * @param contexto Apontador passado a visitar
+ * @return true se a operação foi bem sucedida
+ * @note Para pares alinhados na horizontal, na vertical ou a 45°, os pontos são
+ *       os que dividem o segmento entre as antenas em três partes. Cada antena só
+ *       é comparada com o grupo da sua frequência, pela ordem da lista do grafo.
+ *       Os pares ordenados são os da listagem de CalcularInterferencias, que por
+ *       isso repete cada par e inclui o ponto da própria antena; o mapa de calor
+ *       usa pares distintos, para contar cada interferência real uma vez
+ */
+bool PercorrerInterferencias(Grafo* grafo, bool pares_distintos,
+                             void (*visitar)(void* contexto, int freq, int x, int y), void* contexto) {
+    if (!grafo || !visitar) return false;
+
+    int total_grupos = 0;
+    GrupoFrequencia* grupos = AgruparPorFrequencia(grafo, &total_grupos);
+    if (!grupos) return grafo->total_antenas == 0;
+
+    for (Antena* a1 = grafo->antenas; a1 != NULL; a1 = a1->proxima) {
+        GrupoFrequencia* grupo = &grupos[a1->frequencia];
+        for (int j = 0; j < grupo->total; j++) {
+            Antena* a2 = grupo->antenas[j];
+            if (pares_distintos && a2->indice <= a1->indice) continue;  // Cada par uma vez, sem (a, a)
+            int dx = a2->coluna - a1->coluna;
+            int dy = a2->linha - a1->linha;
+
+            if (dx == 0 || dy == 0 || abs(dx) == abs(dy)) {
+                for (int k = 1; k < 3; k++) {
+                    int x = a1->coluna + (k * dx) / 3;
+                    int y = a1->linha + (k * dy) / 3;
+                    visitar(contexto, a1->frequencia, x, y);
+                }
+            }
+        }
+    }
+
+    LibertarGrupos(grupos, total_grupos);
+    return true;
+}
+
+/**
+ * @brief Escreve um ponto de interferência
+ * @param contexto Ficheiro de saída
+ * @param freq Frequência (não usada)
+ * @param x Coluna do ponto
+ * @param y Linha do ponto
+ */
+void EscreverInterferencia(void* contexto, int freq, int x, int y) {
+    (void)freq;
+    fprintf(contexto, "(%d,%d)\n", x, y);
+}
+
+/**
+ * @brief Calcula pontos de interferência entre antenas
+ * @param grafo Apontador para o grafo
+ * @param saida Ficheiro de saída
+ * @return true se a operação foi bem sucedida
+ */
+bool CalcularInterferencias(Grafo* grafo, FILE* saida) {
+    if (!grafo || !saida) return false;
     
     fprintf(saida, "=== PONTOS DE INTERFERENCIA ===\n");
+    return PercorrerInterferencias(grafo, false, EscreverInterferencia, saida);
+}
+
+/**
+ * @brief Estado do cálculo de um mapa de calor
+ */
+typedef struct CalculoMapaCalor {
+    MapaCalor* mapa;            ///< Mapa a preencher
+    bool sem_memoria;           ///< Posto a true se faltou memória para uma camada
+} CalculoMapaCalor;
+
+/**
+ * @brief Soma um ponto de interferência ao mapa de calor
+ * @param contexto Apontador para o CalculoMapaCalor
+ * @param freq Frequência do ponto
+ * @param x Coluna do ponto
+ * @param y Linha do ponto
+ * @note A camada de uma frequência só é alocada quando recebe o primeiro ponto
+ */
+void SomarInterferencia(void* contexto, int freq, int x, int y) {
+    CalculoMapaCalor* calculo = contexto;
+    MapaCalor* mapa = calculo->mapa;
+    if (x < 0 || y < 0 || x >= mapa->colunas || y >= mapa->linhas) return;
+
+    size_t celula = (size_t)y * mapa->colunas + x;
+    mapa->contagens[mapa->total_frequencias][celula]++;
+    if (!mapa->por_frequencia) return;
+
+    if (!mapa->contagens[freq]) {
+        mapa->contagens[freq] = calloc((size_t)mapa->linhas * mapa->colunas, sizeof(unsigned int));
+        if (!mapa->contagens[freq]) {
+            calculo->sem_memoria = true;
+            return;
+        }
+    }
+    mapa->contagens[freq][celula]++;
+}
+
+/**
+ * @brief Calcula o mapa de calor dos pontos de interferência
+ * @param grafo Apontador para o grafo
+ * @param por_frequencia Se verdadeiro, calcula também uma camada por frequência
+ * @param mapa Apontador para o mapa a preencher
+ * @return true se a operação foi bem sucedida
+ * @note Cada par de antenas distintas da mesma frequência conta uma vez por ponto
+ * @note Só são alocadas a camada do total e, se pedidas, as das frequências com
+ *       interferências na grelha; as restantes ficam a NULL e contam como vazias
+ * @note Além das contagens, constrói para cada camada a tabela de somas acumuladas
+ *       S(l, c) = soma das células com linha < l e coluna < c, que permite contar
+ *       qualquer retângulo com quatro acessos (ContarInterferenciasRegiao)
+ * @warning A memória alocada deve ser libertada com LibertarMapaCalor()
+ */
+bool CalcularMapaCalor(Grafo* grafo, bool por_frequencia, MapaCalor* mapa) {
+    if (!grafo || !mapa) return false;
+
+    mapa->linhas = grafo->linhas > 0 ? grafo->linhas : 0;
+    mapa->colunas = grafo->colunas > 0 ? grafo->colunas : 0;
+    mapa->total_frequencias = grafo->frequencias.total;
+    mapa->por_frequencia = por_frequencia;
+
+    size_t camadas = (size_t)mapa->total_frequencias + 1;
+    size_t celulas = (size_t)mapa->linhas * mapa->colunas;
+    size_t celulas_somas = (size_t)(mapa->linhas + 1) * (mapa->colunas + 1);
+    mapa->contagens = calloc(camadas, sizeof(unsigned int*));
+    mapa->somas = calloc(camadas, sizeof(long long*));
+    if (!mapa->contagens || !mapa->somas) {
+        LibertarMapaCalor(mapa);
+        return false;
+    }
+    mapa->contagens[mapa->total_frequencias] = calloc(celulas + 1, sizeof(unsigned int));
+    if (!mapa->contagens[mapa->total_frequencias]) {
+        LibertarMapaCalor(mapa);
+        return false;
+    }
+
+    CalculoMapaCalor calculo = { mapa, false };
+    if (!PercorrerInterferencias(grafo, true, SomarInterferencia, &calculo) || calculo.sem_memoria) {
+        LibertarMapaCalor(mapa);
+        return false;
+    }
+
+    for (size_t f = 0; f < camadas; f++) {
+        const unsigned int* contagens = mapa->contagens[f];
+        if (!contagens) continue;  // Frequência sem interferências na grelha
+
+        long long* somas = malloc(celulas_somas * sizeof(long long));
+        if (!somas) {
+            LibertarMapaCalor(mapa);
+            return false;
+        }
+        mapa->somas[f] = somas;
+        int largura = mapa->colunas + 1;
+
+        for (int c = 0; c <= mapa->colunas; c++) somas[c] = 0;
+        for (int l = 1; l <= mapa->linhas; l++) {
+            long long linha = 0;  // Soma da linha l-1 até à coluna c-1
+            somas[l * largura] = 0;
+            for (int c = 1; c <= mapa->colunas; c++) {
+                linha += contagens[(l - 1) * mapa->colunas + (c - 1)];
+                somas[l * largura + c] = somas[(l - 1) * largura + c] + linha;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Conta as interferências num retângulo da grelha
+ * @param mapa Apontador para o mapa de calor
+ * @param frequencia Identificador da frequência, ou -1 para todas
+ * @param col_min Primeira coluna
+ * @param lin_min Primeira linha
+ * @param col_max Última coluna (inclusive)
+ * @param lin_max Última linha (inclusive)
+ * @return Número de interferências no retângulo
+ * @note O retângulo é recortado aos limites da grelha
+ */
+long long ContarInterferenciasRegiao(const MapaCalor* mapa, int frequencia,
+                                     int col_min, int lin_min, int col_max, int lin_max) {
+    if (!mapa || !mapa->somas || frequencia < -1 || frequencia >= mapa->total_frequencias) return 0;
+    if (frequencia != -1 && !mapa->por_frequencia) return 0;
+
+    if (col_min < 0) col_min = 0;
+    if (lin_min < 0) lin_min = 0;
+    if (col_max >= mapa->colunas) col_max = mapa->colunas - 1;
+    if (lin_max >= mapa->linhas) lin_max = mapa->linhas - 1;
+    if (col_min > col_max || lin_min > lin_max) return 0;
+
+    int camada = frequencia == -1 ? mapa->total_frequencias : frequencia;
+    const long long* somas = mapa->somas[camada];
+    if (!somas) return 0;  // Camada sem interferências
+    int largura = mapa->colunas + 1;
+
+    return somas[(lin_max + 1) * largura + (col_max + 1)]
+         - somas[lin_min * largura + (col_max + 1)]
+         - somas[(lin_max + 1) * largura + col_min]
+         + somas[lin_min * largura + col_min];
+}
+
+/**
+ * @brief Calcula a densidade de interferências num retângulo da grelha
+ * @param mapa Apontador para o mapa de calor
+ * @param frequencia Identificador da frequência, ou -1 para todas
+ * @param col_min Primeira coluna
+ * @param lin_min Primeira linha
+ * @param col_max Última coluna (inclusive)
+ * @param lin_max Última linha (inclusive)
+ * @return Interferências por célula do retângulo recortado à grelha (0 se vazio)
+ */
+double DensidadeInterferenciasRegiao(const MapaCalor* mapa, int frequencia,
+                                     int col_min, int lin_min, int col_max, int lin_max) {
+    if (!mapa) return 0.0;
+
+    if (col_min < 0) col_min = 0;
+    if (lin_min < 0) lin_min = 0;
+    if (col_max >= mapa->colunas) col_max = mapa->colunas - 1;
+    if (lin_max >= mapa->linhas) lin_max = mapa->linhas - 1;
+    if (col_min > col_max || lin_min > lin_max) return 0.0;
+
+    long long area = (long long)(col_max - col_min + 1) * (lin_max - lin_min + 1);
+    return (double)ContarInterferenciasRegiao(mapa, frequencia, col_min, lin_min, col_max, lin_max) / area;
+}
+
+/**
+ * @brief Exporta uma camada do mapa de calor como imagem PGM binária
+ * @param mapa Apontador para o mapa de calor
+ * @param frequencia Identificador da frequência, ou -1 para o total
+ * @param nome_ficheiro Nome do ficheiro de saída
+ * @return true se a operação foi bem sucedida
+ * @note Cada pixel é a contagem da célula. O valor máximo da imagem é a maior
+ *       contagem; acima de 255 usam-se 2 bytes por pixel (big-endian), como
+ *       define o formato, e contagens acima de 65535 são limitadas
+ * @note Uma frequência sem interferências dá uma imagem a zeros
+ */
+bool ExportarMapaCalorPGM(const MapaCalor* mapa, int frequencia, const char* nome_ficheiro) {
+    if (!mapa || !mapa->contagens || !nome_ficheiro) return false;
+    if (frequencia < -1 || frequencia >= mapa->total_frequencias) return false;
+    if (frequencia != -1 && !mapa->por_frequencia) return false;
+
+    int camada = frequencia == -1 ? mapa->total_frequencias : frequencia;
+    size_t celulas = (size_t)mapa->linhas * mapa->colunas;
+    const unsigned int* contagens = mapa->contagens[camada];  // NULL se a camada estiver vazia
+
+    unsigned int maximo = 1;  // O formato exige um valor máximo positivo
+    for (size_t i = 0; contagens && i < celulas; i++) {
+        if (contagens[i] > maximo) maximo = contagens[i];
+    }
+    if (maximo > 65535) maximo = 65535;
+
+    FILE* saida = fopen(nome_ficheiro, "wb");
+    if (!saida) {
+        perror("Erro ao criar ficheiro");
+        return false;
+    }
+
+    fprintf(saida, "P5\n%d %d\n%u\n", mapa->colunas, mapa->linhas, maximo);
+    for (size_t i = 0; i < celulas; i++) {
+        unsigned int valor = !contagens ? 0 : contagens[i] > maximo ? maximo : contagens[i];
+        if (maximo > 255) fputc((int)(valor >> 8), saida);
+        fputc((int)(valor & 0xFF), saida);
+    }
+
+    return fclose(saida) == 0;
+}
+
+/**
+ * @brief Exporta as camadas de contagens calculadas do mapa de calor num ficheiro binário
+ * @param mapa Apontador para o mapa de calor
+ * @param nome_ficheiro Nome do ficheiro de saída
+ * @return true se a operação foi bem sucedida
+ * @note Formato: os 4 bytes "MCAL", depois linhas, colunas e total de frequências
+ *       como inteiros de 32 bits, e as contagens (32 bits) de cada camada por
+ *       linhas, terminando na camada do total. Tudo em little-endian.
+ * @note As camadas vazias são escritas a zeros. Um mapa só com o total é escrito
+ *       com 0 frequências, ficando apenas a camada do total
+ */
+bool ExportarMapaCalorBinario(const MapaCalor* mapa, const char* nome_ficheiro) {
+    if (!mapa || !mapa->contagens || !nome_ficheiro) return false;
+
+    FILE* saida = fopen(nome_ficheiro, "wb");
+    if (!saida) {
+        perror("Erro ao criar ficheiro");
+        return false;
+    }
+
+    fwrite("MCAL", 1, 4, saida);
+    int primeira = mapa->por_frequencia ? 0 : mapa->total_frequencias;  // Primeira camada escrita
+    unsigned int cabecalho[3] = { (unsigned int)mapa->linhas, (unsigned int)mapa->colunas,
+                                  (unsigned int)(mapa->total_frequencias - primeira) };
+    size_t celulas = (size_t)mapa->linhas * mapa->colunas;
+
+    unsigned char bytes[4];
+    for (int i = 0; i < 3; i++) {
+        for (int b = 0; b < 4; b++) bytes[b] = (unsigned char)(cabecalho[i] >> (8 * b));
+        fwrite(bytes, 1, 4, saida);
+    }
+    for (int f = primeira; f <= mapa->total_frequencias; f++) {
+        const unsigned int* contagens = mapa->contagens[f];
+        for (size_t i = 0; i < celulas; i++) {
+            unsigned int valor = contagens ? contagens[i] : 0;
+            for (int b = 0; b < 4; b++) bytes[b] = (unsigned char)(valor >> (8 * b));
+            fwrite(bytes, 1, 4, saida);
+        }
+    }
+
+    return fclose(saida) == 0;
+}
+
+/**
+ * @brief Liberta a memória de um mapa de calor
+ * @param mapa Apontador para o mapa
+ * @return true se a operação foi bem sucedida
+ */
+bool LibertarMapaCalor(MapaCalor* mapa) {
+    if (!mapa) return false;
+    for (int f = 0; f <= mapa->total_frequencias; f++) {
+        if (mapa->contagens) free(mapa->contagens[f]);
+        if (mapa->somas) free(mapa->somas[f]);
+    }
+    free(mapa->contagens);
+    free(mapa->somas);
+    mapa->contagens = NULL;
+    mapa->somas = NULL;
+    return true;
+}
+
+/**
+ * @brief Calcula o máximo divisor comum de dois inteiros
+ * @param a Primeiro valor
+ * @param b Segundo valor
+ * @return Máximo divisor comum dos valores absolutos de a e b
+ */
+int MaximoDivisorComum(int a, int b) {
+    a = abs(a);
+    b = abs(b);
+    while (b != 0) {
+        int resto = a % b;
+        a = b;
+        b = resto;
+    }
+    return a;
+}
+
+/**
+ * @brief Entrada da tabela de dispersão de direções usada em CalcularColineares
+ */
+typedef struct EntradaDirecao {
+    int dx;                     ///< Componente horizontal da direção normalizada
+    int dy;                     ///< Componente vertical da direção normalizada
+    int contagem;               ///< Número de antenas nesta direção a partir da âncora
+    int primeira;               ///< Índice (no grupo) da primeira antena nesta direção
+    int ultima;                 ///< Índice (no grupo) da última antena nesta direção
+    bool ocupada;               ///< Indica se a entrada está em uso
+} EntradaDirecao;
+
+/**
+ * @brief Deteta conjuntos de três ou mais antenas da mesma frequência alinhadas
+ * @param grafo Apontador para o grafo
+ * @param saida Ficheiro de saída
+ * @return true se a operação foi bem sucedida
+ * @note Para cada antena âncora, as direções para as restantes antenas do grupo
+ *       são reduzidas por (dx/mdc, dy/mdc) e agrupadas numa tabela de dispersão,
+ *       o que dá O(n²) por grupo. Cada reta só é escrita a partir da sua
+ *       antena de menor índice, para não aparecer repetida.
+ */
+bool CalcularColineares(Grafo* grafo, FILE* saida) {
+    if (!grafo || !saida) return false;
+
+    int total_grupos = 0;
+    GrupoFrequencia* grupos = AgruparPorFrequencia(grafo, &total_grupos);
+    if (!grupos) return grafo->total_antenas == 0;
+
+    bool sucesso = true;
+    for (int g = 0; g < total_grupos && sucesso; g++) {
+        GrupoFrequencia* grupo = &grupos[g];
+        if (grupo->total < 3) continue;
+
+        int capacidade = 1;
+        while (capacidade < 2 * grupo->total) capacidade <<= 1;
+
+        EntradaDirecao* tabela = malloc(capacidade * sizeof(EntradaDirecao));
+        int* seguinte = malloc(grupo->total * sizeof(int));  // Próxima antena na mesma direção
+        int* balde = malloc(grupo->total * sizeof(int));     // Entrada da tabela de cada antena
+        if (!tabela || !seguinte || !balde) {
+            free(tabela);
+            free(seguinte);
+            free(balde);
+            sucesso = false;
+            break;
+        }
+
+        for (int i = 0; i < grupo->total; i++) {
+            Antena* ancora = grupo->antenas[i];
+            memset(tabela, 0, capacidade * sizeof(EntradaDirecao));
+
+            for (int j = 0; j < grupo->total; j++) {
+                if (j == i) continue;
+                int dx = grupo->antenas[j]->coluna - ancora->coluna;
+                int dy = grupo->antenas[j]->linha - ancora->linha;
+                int mdc = MaximoDivisorComum(dx, dy);
+                if (mdc == 0) {  // Antena na mesma posição da âncora: não define direção
+                    balde[j] = -1;
+                    continue;
+                }
+                dx /= mdc;
+                dy /= mdc;
+                if (dx < 0 || (dx == 0 && dy < 0)) {  // Sentidos opostos pertencem à mesma reta
+                    dx = -dx;
+                    dy = -dy;
+                }
+
+                unsigned int h = ((unsigned int)dx * 73856093u) ^ ((unsigned int)dy * 19349663u);
+                int pos = (int)(h & (unsigned int)(capacidade - 1));
+                while (tabela[pos].ocupada && (tabela[pos].dx != dx || tabela[pos].dy != dy)) {
+                    pos = (pos + 1) & (capacidade - 1);
+                }
+
+                EntradaDirecao* entrada = &tabela[pos];
+                if (!entrada->ocupada) {
+                    entrada->ocupada = true;
+                    entrada->dx = dx;
+                    entrada->dy = dy;
+                    entrada->primeira = j;
+                } else {
+                    seguinte[entrada->ultima] = j;
+                }
+                entrada->ultima = j;
+                entrada->contagem++;
+                seguinte[j] = -1;
+                balde[j] = pos;
+            }
+
+            for (int j = 0; j < grupo->total; j++) {
+                if (j == i || balde[j] == -1) continue;
+                EntradaDirecao* entrada = &tabela[balde[j]];
+                if (entrada->primeira != j || entrada->contagem < 2 || entrada->primeira < i) continue;
+
+                const char* rotulo = RotuloFrequencia(grafo, grupo->frequencia);
+                fprintf(saida, "%s(%d,%d)", rotulo, ancora->coluna, ancora->linha);
+                for (int k = j; k != -1; k = seguinte[k]) {
+                    fprintf(saida, " - %s(%d,%d)", rotulo, grupo->antenas[k]->coluna,
+                                                   grupo->antenas[k]->linha);
+                }
+                fprintf(saida, "\n");
+            }
+        }
+
+        free(tabela);
+        free(seguinte);
+        free(balde);
+    }
+
+    LibertarGrupos(grupos, total_grupos);
+    return sucesso;
+}
+
+/**
+ * @brief Escreve a lista de antenas
+ * @param grafo Apontador para o grafo
+ * @param saida Ficheiro de saída
+ * @return true se a operação foi bem sucedida
+ */
+bool EscreverSeccaoAntenas(Grafo* grafo, FILE* saida) {
+    fprintf(saida, "=== ANTENAS (%d) ===\n", grafo->total_antenas);
+    for (Antena* a = grafo->antenas; a != NULL; a = a->proxima) {
+        fprintf(saida, "%s @ (%d,%d)\n", RotuloFrequencia(grafo, a->frequencia), a->coluna, a->linha);
+    }
+    return true;
+}
+
+/**
+ * @brief Escreve as travessias em profundidade e em largura
+ * @param grafo Apontador para o grafo
+ * @param saida Ficheiro de saída
+ * @return true se a operação foi bem sucedida
+ * @note É a única secção que usa os marcadores visitada das antenas
+ */
+bool EscreverSeccaoTravessias(Grafo* grafo, FILE* saida) {
+    if (grafo->total_antenas == 0) return true;
+    Antena* primeira = grafo->antenas;
     
+    fprintf(saida, "\n=== BUSCA EM PROFUNDIDADE ===\n");
+    bool sucesso = ProcuraEmProfundidade(grafo, primeira, saida);
+    LimparVisitados(grafo);
+
+    fprintf(saida, "\n=== BUSCA EM LARGURA ===\n");
+    if (!ProcuraEmLargura(grafo, primeira, saida)) sucesso = false;
+    LimparVisitados(grafo);
+    return sucesso;
+}
+
+/**
+ * @brief Escreve todos os caminhos entre a primeira e a terceira antena
+ * @param grafo Apontador para o grafo
+ * @param saida Ficheiro de saída
+ * @return true se a operação foi bem sucedida
+ * @note Usa EncontrarCaminhosParalelo, que não depende dos marcadores visitada
+ */
+bool EscreverSeccaoCaminhos(Grafo* grafo, FILE* saida) {
+    if (grafo->total_antenas <= 2) return true;
+
+    Antena* primeira = grafo->antenas;
+    Antena* terceira = primeira->proxima->proxima;
+    fprintf(saida, "\n=== CAMINHOS ENTRE ANTENAS ===\n");
+    return EncontrarCaminhosParalelo(grafo, primeira, terceira, saida, NULL);
+}
+
+/**
+ * @brief Escreve as intersecções entre antenas de frequências diferentes
+ * @param grafo Apontador para o grafo
+ * @param saida Ficheiro de saída
+ * @return true se a operação foi bem sucedida
+ */
+bool EscreverSeccaoIntersecoes(Grafo* grafo, FILE* saida) {
+    if (grafo->total_antenas == 0) return true;
+
+    int total_grupos = 0;
+    GrupoFrequencia* grupos = AgruparPorFrequencia(grafo, &total_grupos);
+    if (!grupos) return false;
+
+    // Os grupos são construídos uma vez e partilhados por todas as chamadas
+    fprintf(saida, "\n=== INTERSECOES ===\n");
     for (Antena* a1 = grafo->antenas; a1 != NULL; a1 = a1->proxima) {
         for (Antena* a2 = grafo->antenas; a2 != NULL; a2 = a2->proxima) {
-            if (a1->frequencia == a2->frequencia) {
-                int dx = a2->coluna - a1->coluna;
-                int dy = a2->linha - a1->linha;
-
-                if (dx == 0 || dy == 0 || abs(dx) == abs(dy)) {
-                    for (int k = 1; k < 3; k++) {
-                        int x = a1->coluna + (k * dx) / 3;
-                        int y = a1->linha + (k * dy) / 3;
-                        fprintf(saida, "(%d,%d)\n", x, y);
-                    }
-                }
+            if (a1->frequencia != a2->frequencia) {
+                EscreverIntersecoesGrupos(grafo, &grupos[a1->frequencia], &grupos[a2->frequencia], saida);
             }
         }
     }
+
+    LibertarGrupos(grupos, total_grupos);
     return true;
 }
 
+/**
+ * @brief Escreve os pontos de interferência
+ * @param grafo Apontador para o grafo
+ * @param saida Ficheiro de saída
+ * @return true se a operação foi bem sucedida
+ */
+bool EscreverSeccaoInterferencias(Grafo* grafo, FILE* saida) {
+    if (grafo->total_antenas == 0) return true;
+
+    fprintf(saida, "\n=== INTERFERENCIAS ===\n");
+    return CalcularInterferencias(grafo, saida);
+}
+
+/**
+ * @brief Escreve os conjuntos de antenas colineares
+ * @param grafo Apontador para o grafo
+ * @param saida Ficheiro de saída
+ * @return true se a operação foi bem sucedida
+ */
+bool EscreverSeccaoColineares(Grafo* grafo, FILE* saida) {
+    if (grafo->total_antenas == 0) return true;
+
+    fprintf(saida, "\n=== ANTENAS COLINEARES ===\n");
+    return CalcularColineares(grafo, saida);
+}
+
+/**
+ * @brief Função que escreve uma secção do ficheiro de resultados
+ */
+typedef bool (*FuncaoSeccao)(Grafo* grafo, FILE* saida);
+
+/**
+ * @brief Secção do ficheiro de resultados
+ */
+typedef struct SeccaoResultados {
+    FuncaoSeccao escrever;      ///< Função que escreve a secção
+    bool usa_ligacoes;          ///< Indica se a secção percorre as ligações entre antenas
+} SeccaoResultados;
+
+/**
+ * @brief Secções do ficheiro de resultados, pela ordem em que são escritas
+ */
+static const SeccaoResultados SECCOES[] = {
+    { EscreverSeccaoAntenas, false },
+    { EscreverSeccaoTravessias, true },
+    { EscreverSeccaoCaminhos, true },
+    { EscreverSeccaoIntersecoes, false },
+    { EscreverSeccaoInterferencias, false },
+    { EscreverSeccaoColineares, false }
+};
+
+#define TOTAL_SECCOES ((int)(sizeof(SECCOES) / sizeof(SECCOES[0])))  ///< Número de secções
+
 /**
  * @brief Exporta todos os resultados para um ficheiro
  * @param grafo Grafo a ser analisado
  * @param nome_ficheiro Nome do ficheiro de saída
- * @return true se a operação foi bem sucedida
+ * @return true se todas as secções e a escrita foram bem sucedidas
+ * @note As ligações do grafo já devem estar construídas (ver ConstruirLigacoes)
+ * @note Uma secção que falha não interrompe as restantes, mas o resultado é false
  */
 bool ExportarResultados(Grafo grafo, const char* nome_ficheiro) {
     if (!nome_ficheiro) return false;
@@ -310,45 +2050,394 @@ bool ExportarResultados(Grafo grafo, const char* nome_ficheiro) {
         return false;
     }
 
-    fprintf(saida, "=== ANTENAS (%d) ===\n", grafo.total_antenas);
-    for (Antena* a = grafo.antenas; a != NULL; a = a->proxima) {
-        fprintf(saida, "%c @ (%d,%d)\n", a->frequencia, a->coluna, a->linha);
+    bool sucesso = true;
+    for (int i = 0; i < TOTAL_SECCOES; i++) {
+        if (!SECCOES[i].escrever(&grafo, saida)) {
+            fprintf(stderr, "Erro ao calcular a secção %d dos resultados\n", i + 1);
+            sucesso = false;
+        }
     }
+    
+    if (ferror(saida)) sucesso = false;
+    if (fclose(saida) != 0) sucesso = false;
+    return sucesso;
+}
 
-    if (grafo.total_antenas > 0) {
-        Antena* primeira = grafo.antenas;
-        
-        fprintf(saida, "\n=== BUSCA EM PROFUNDIDADE ===\n");
-        ProcuraEmProfundidade(&grafo, primeira, saida);
-        LimparVisitados(&grafo);
+/**
+ * @brief Estado partilhado pelas threads da exportação em pipeline
+ */
+typedef struct ExportacaoPipeline {
+    Grafo* grafo;                       ///< Grafo a analisar
+    FILE* saida;                        ///< Ficheiro final, escrito só pela thread de escrita
+    FILE* parciais[TOTAL_SECCOES];      ///< Resultado de cada secção, em ficheiro temporário
+    bool prontas[TOTAL_SECCOES];        ///< Indica as secções já calculadas
+    int ordem[TOTAL_SECCOES];           ///< Ordem de cálculo: primeiro as que não usam ligações
+    int proxima;                        ///< Posição em ordem da próxima secção por calcular
+    bool sucesso;                       ///< Falso se alguma secção ou escrita falhou
+    bool ligacoes_prontas;              ///< Indica que a construção das ligações terminou
+    bool ligacoes_ok;                   ///< Falso se a construção das ligações falhou
+    pthread_mutex_t trinco;             ///< Protege prontas, proxima, sucesso e ligacoes_*
+    pthread_cond_t secao_pronta;        ///< Sinalizada quando uma secção fica pronta
+    pthread_cond_t ligacoes_construidas; ///< Sinalizada quando as ligações ficam prontas
+} ExportacaoPipeline;
+
+/**
+ * @brief Função das threads que calculam secções da exportação em pipeline
+ * @param arg Apontador para a ExportacaoPipeline
+ * @return NULL
+ * @note Uma secção que usa ligações espera que a sua construção termine
+ */
+void* CalcularSeccoesTrabalhador(void* arg) {
+    ExportacaoPipeline* exportacao = arg;
+
+    for (;;) {
+        pthread_mutex_lock(&exportacao->trinco);
+        int posicao = exportacao->proxima++;
+        int i = posicao < TOTAL_SECCOES ? exportacao->ordem[posicao] : -1;
+        bool ligacoes_ok = true;
+        if (i >= 0 && SECCOES[i].usa_ligacoes) {
+            while (!exportacao->ligacoes_prontas) {
+                pthread_cond_wait(&exportacao->ligacoes_construidas, &exportacao->trinco);
+            }
+            ligacoes_ok = exportacao->ligacoes_ok;
+        }
+        pthread_mutex_unlock(&exportacao->trinco);
+        if (i < 0) break;
+
+        bool calculada = ligacoes_ok && SECCOES[i].escrever(exportacao->grafo, exportacao->parciais[i]);
+        if (!calculada) fprintf(stderr, "Erro ao calcular a secção %d dos resultados\n", i + 1);
 
-        fprintf(saida, "\n=== BUSCA EM LARGURA ===\n");
-        ProcuraEmLargura(&grafo, primeira, saida);
-        LimparVisitados(&grafo);
+        pthread_mutex_lock(&exportacao->trinco);
+        if (!calculada || ferror(exportacao->parciais[i])) exportacao->sucesso = false;
+        exportacao->prontas[i] = true;
+        pthread_cond_broadcast(&exportacao->secao_pronta);
+        pthread_mutex_unlock(&exportacao->trinco);
+    }
+    return NULL;
+}
 
-        if (grafo.total_antenas > 2) {
-            Antena* terceira = primeira->proxima->proxima;
-            fprintf(saida, "\n=== CAMINHOS ENTRE ANTENAS ===\n");
-            EncontrarCaminhos(&grafo, primeira, terceira, saida);
+/**
+ * @brief Função da thread de escrita: copia as secções para o ficheiro, por ordem
+ * @param arg Apontador para a ExportacaoPipeline
+ * @return NULL
+ */
+void* EscreverSeccoesTrabalhador(void* arg) {
+    ExportacaoPipeline* exportacao = arg;
+    char buffer[8192];
+
+    for (int i = 0; i < TOTAL_SECCOES; i++) {
+        pthread_mutex_lock(&exportacao->trinco);
+        while (!exportacao->prontas[i]) {
+            pthread_cond_wait(&exportacao->secao_pronta, &exportacao->trinco);
         }
+        pthread_mutex_unlock(&exportacao->trinco);
 
-        fprintf(saida, "\n=== INTERSECOES ===\n");
-        for (Antena* a1 = grafo.antenas; a1 != NULL; a1 = a1->proxima) {
-            for (Antena* a2 = grafo.antenas; a2 != NULL; a2 = a2->proxima) {
-                if (a1->frequencia != a2->frequencia) {
-                    MostrarIntersecoes(&grafo, a1->frequencia, a2->frequencia, saida);
-                }
+        FILE* parcial = exportacao->parciais[i];
+        rewind(parcial);
+        size_t lidos;
+        while ((lidos = fread(buffer, 1, sizeof(buffer), parcial)) > 0) {
+            if (fwrite(buffer, 1, lidos, exportacao->saida) != lidos) {
+                pthread_mutex_lock(&exportacao->trinco);
+                exportacao->sucesso = false;
+                pthread_mutex_unlock(&exportacao->trinco);
+                break;
             }
         }
+        if (ferror(parcial)) {
+            pthread_mutex_lock(&exportacao->trinco);
+            exportacao->sucesso = false;
+            pthread_mutex_unlock(&exportacao->trinco);
+        }
+        fclose(parcial);
+        exportacao->parciais[i] = NULL;
+    }
+    return NULL;
+}
 
-        fprintf(saida, "\n=== INTERFERENCIAS ===\n");
-        CalcularInterferencias(&grafo, saida);
+/**
+ * @brief Exporta todos os resultados calculando as secções em paralelo
+ * @param grafo Grafo a ser analisado (as ligações são construídas se faltarem)
+ * @param nome_ficheiro Nome do ficheiro de saída
+ * @return true se a operação foi bem sucedida
+ * @note As secções são independentes entre si (só EscreverSeccaoTravessias usa
+ *       os marcadores visitada), por isso são calculadas em simultâneo por até
+ *       NumeroTrabalhadores() threads, cada uma num ficheiro temporário. Uma thread
+ *       de escrita copia-as para o ficheiro final pela ordem de ExportarResultados,
+ *       assim que cada uma fica pronta. O resultado é igual ao da versão sequencial.
+ * @note Se o grafo ainda não tiver ligações, a thread atual constrói-as com
+ *       ConstruirLigacoes (paralela por grupo) enquanto as outras calculam as
+ *       secções que não as usam; as restantes esperam que a construção termine.
+ *       Com um só processador exporta sequencialmente, sem threads nem temporários.
+ */
+bool ExportarResultadosEmPipeline(Grafo* grafo, const char* nome_ficheiro) {
+    if (!grafo || !nome_ficheiro) return false;
+    if (NumeroTrabalhadores() == 1) return ConstruirLigacoes(grafo) && ExportarResultados(*grafo, nome_ficheiro);
+
+    ExportacaoPipeline exportacao;
+    exportacao.grafo = grafo;
+    exportacao.proxima = 0;
+    exportacao.sucesso = true;
+    exportacao.ligacoes_prontas = grafo->com_ligacoes;
+    exportacao.ligacoes_ok = true;
+    int n = 0;
+    for (int i = 0; i < TOTAL_SECCOES; i++) {
+        if (!SECCOES[i].usa_ligacoes) exportacao.ordem[n++] = i;
     }
-    
-    fclose(saida);
+    for (int i = 0; i < TOTAL_SECCOES; i++) {
+        if (SECCOES[i].usa_ligacoes) exportacao.ordem[n++] = i;
+    }
+    for (int i = 0; i < TOTAL_SECCOES; i++) {
+        exportacao.prontas[i] = false;
+        exportacao.parciais[i] = tmpfile();
+        if (!exportacao.parciais[i]) {
+            for (int j = 0; j < i; j++) fclose(exportacao.parciais[j]);
+            // Sem ficheiros temporários, exporta sequencialmente
+            return ConstruirLigacoes(grafo) && ExportarResultados(*grafo, nome_ficheiro);
+        }
+    }
+
+    exportacao.saida = fopen(nome_ficheiro, "w");
+    if (!exportacao.saida) {
+        perror("Erro ao criar ficheiro");
+        for (int i = 0; i < TOTAL_SECCOES; i++) fclose(exportacao.parciais[i]);
+        return false;
+    }
+
+    pthread_mutex_init(&exportacao.trinco, NULL);
+    pthread_cond_init(&exportacao.secao_pronta, NULL);
+    pthread_cond_init(&exportacao.ligacoes_construidas, NULL);
+
+    pthread_t escritor;
+    bool escritor_criado = pthread_create(&escritor, NULL, EscreverSeccoesTrabalhador, &exportacao) == 0;
+
+    // Enquanto a thread atual constrói as ligações, conta mais uma thread de secções
+    int num_threads = NumeroTrabalhadores() + (grafo->com_ligacoes ? 0 : 1);
+    pthread_t threads[MAXIMO_TRABALHADORES + 1];
+    int criadas = 0;
+    for (int t = 1; t < num_threads && t < TOTAL_SECCOES; t++) {
+        if (pthread_create(&threads[criadas], NULL, CalcularSeccoesTrabalhador, &exportacao) != 0) break;
+        criadas++;
+    }
+
+    if (!exportacao.ligacoes_prontas) {
+        bool construidas = ConstruirLigacoes(grafo);
+        if (!construidas) fprintf(stderr, "Erro ao construir as ligações entre antenas\n");
+
+        pthread_mutex_lock(&exportacao.trinco);
+        exportacao.ligacoes_ok = construidas;
+        exportacao.ligacoes_prontas = true;
+        pthread_cond_broadcast(&exportacao.ligacoes_construidas);
+        pthread_mutex_unlock(&exportacao.trinco);
+    }
+
+    CalcularSeccoesTrabalhador(&exportacao);  // A thread atual também calcula secções
+
+    for (int t = 0; t < criadas; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    if (escritor_criado) pthread_join(escritor, NULL);
+    else EscreverSeccoesTrabalhador(&exportacao);  // Todas as secções já estão prontas
+
+    pthread_mutex_destroy(&exportacao.trinco);
+    pthread_cond_destroy(&exportacao.secao_pronta);
+    pthread_cond_destroy(&exportacao.ligacoes_construidas);
+
+    if (fclose(exportacao.saida) != 0) exportacao.sucesso = false;
+    return exportacao.sucesso;
+}
+
+/**
+ * @brief Acrescenta bytes a um valor de dispersão FNV-1a de 64 bits
+ * @param hash Valor de dispersão atual
+ * @param dados Bytes a acrescentar
+ * @param tamanho Número de bytes
+ * @return Novo valor de dispersão
+ */
+unsigned long long DispersarBytes(unsigned long long hash, const void* dados, size_t tamanho) {
+    const unsigned char* bytes = dados;
+    for (size_t i = 0; i < tamanho; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Calcula a chave da cache de resultados para um grafo
+ * @param grafo Apontador para o grafo
+ * @return Valor de dispersão das antenas (pela ordem da lista) e das opções de análise
+ * @note Usa o rótulo de cada frequência, e não o identificador, que depende da ordem de leitura
+ * @note A ordem das antenas entra na chave porque determina a ordem dos resultados
+ */
+unsigned long long CalcularChaveCache(Grafo* grafo) {
+    unsigned long long hash = 14695981039346656037ULL;
+    int versao = VERSAO_ANALISE;
+    hash = DispersarBytes(hash, &versao, sizeof(versao));
+    if (!grafo) return hash;
+
+    hash = DispersarBytes(hash, &grafo->total_antenas, sizeof(grafo->total_antenas));
+    for (Antena* a = grafo->antenas; a != NULL; a = a->proxima) {
+        const char* rotulo = RotuloFrequencia(grafo, a->frequencia);
+        hash = DispersarBytes(hash, rotulo, strlen(rotulo) + 1);
+        hash = DispersarBytes(hash, &a->coluna, sizeof(a->coluna));
+        hash = DispersarBytes(hash, &a->linha, sizeof(a->linha));
+    }
+    return hash;
+}
+
+/**
+ * @brief Copia o conteúdo de um ficheiro para outro
+ * @param origem Nome do ficheiro de origem
+ * @param destino Nome do ficheiro de destino
+ * @return true se a cópia foi bem sucedida
+ */
+bool CopiarFicheiro(const char* origem, const char* destino) {
+    FILE* entrada = fopen(origem, "rb");
+    if (!entrada) return false;
+    FILE* saida = fopen(destino, "wb");
+    if (!saida) {
+        fclose(entrada);
+        return false;
+    }
+
+    char buffer[8192];
+    size_t lidos;
+    bool sucesso = true;
+    while ((lidos = fread(buffer, 1, sizeof(buffer), entrada)) > 0) {
+        if (fwrite(buffer, 1, lidos, saida) != lidos) {
+            sucesso = false;
+            break;
+        }
+    }
+    if (ferror(entrada)) sucesso = false;
+
+    fclose(entrada);
+    if (fclose(saida) != 0) sucesso = false;
+    return sucesso;
+}
+
+/**
+ * @brief Entrada da cache usada na remoção por ordem de utilização
+ */
+typedef struct EntradaCache {
+    char caminho[1024];         ///< Caminho do ficheiro da entrada
+    long tamanho;               ///< Tamanho em bytes
+    time_t ultimo_uso;          ///< Data da última utilização (data de modificação)
+} EntradaCache;
+
+/**
+ * @brief Compara entradas da cache pela data de utilização, da mais antiga para a mais recente
+ */
+int CompararEntradasCache(const void* a, const void* b) {
+    const EntradaCache* ea = a;
+    const EntradaCache* eb = b;
+    if (ea->ultimo_uso != eb->ultimo_uso) return ea->ultimo_uso < eb->ultimo_uso ? -1 : 1;
+    return strcmp(ea->caminho, eb->caminho);
+}
+
+/**
+ * @brief Remove as entradas menos usadas até a cache caber no limite
+ * @param pasta_cache Pasta da cache
+ * @param limite Tamanho máximo em bytes
+ * @return true se a operação foi bem sucedida
+ */
+bool LimitarCache(const char* pasta_cache, long limite) {
+    DIR* pasta = opendir(pasta_cache);
+    if (!pasta) return false;
+
+    EntradaCache* entradas = NULL;
+    int total = 0, capacidade = 0;
+    long ocupado = 0;
+    struct dirent* item;
+    while ((item = readdir(pasta)) != NULL) {
+        size_t tamanho_nome = strlen(item->d_name);
+        if (tamanho_nome < 4 || strcmp(item->d_name + tamanho_nome - 4, ".txt") != 0) continue;
+
+        if (total == capacidade) {
+            capacidade = capacidade ? capacidade * 2 : 16;
+            EntradaCache* novas = realloc(entradas, capacidade * sizeof(EntradaCache));
+            if (!novas) break;
+            entradas = novas;
+        }
+
+        EntradaCache* entrada = &entradas[total];
+        snprintf(entrada->caminho, sizeof(entrada->caminho), "%s/%s", pasta_cache, item->d_name);
+        struct stat info;
+        if (stat(entrada->caminho, &info) != 0) continue;
+        entrada->tamanho = (long)info.st_size;
+        entrada->ultimo_uso = info.st_mtime;
+        ocupado += entrada->tamanho;
+        total++;
+    }
+    closedir(pasta);
+
+    qsort(entradas, total, sizeof(EntradaCache), CompararEntradasCache);
+    for (int i = 0; i < total && ocupado > limite; i++) {
+        if (remove(entradas[i].caminho) == 0) ocupado -= entradas[i].tamanho;
+    }
+
+    free(entradas);
     return true;
 }
 
+/**
+ * @brief Exporta os resultados, reutilizando-os da cache em disco quando possível
+ * @param grafo Grafo a ser analisado, com ou sem ligações construídas
+ * @param nome_ficheiro Nome do ficheiro de saída
+ * @param pasta_cache Pasta da cache
+ * @param pipeline Se verdadeiro, numa falha da cache usa ExportarResultadosEmPipeline
+ * @return true se a operação foi bem sucedida
+ * @note Cada entrada é um ficheiro com o nome da chave de CalcularChaveCache, que
+ *       só depende das antenas lidas; por isso a chave é calculada antes de
+ *       ConstruirLigacoes e um acerto na cache dispensa a construção das ligações.
+ *       Numa falha da cache os resultados são calculados normalmente e guardados;
+ *       a data de modificação serve de data de utilização para a remoção LRU,
+ *       aplicada quando a pasta excede CACHE_LIMITE_BYTES.
+ */
+bool ExportarResultadosComCache(Grafo* grafo, const char* nome_ficheiro, const char* pasta_cache, bool pipeline) {
+    if (!grafo || !nome_ficheiro) return false;
+
+    char caminho[1024];
+    if (pasta_cache) {
+        snprintf(caminho, sizeof(caminho), "%s/%016llx.txt", pasta_cache, CalcularChaveCache(grafo));
+        if (CopiarFicheiro(caminho, nome_ficheiro)) {
+            utime(caminho, NULL);  // Marca a entrada como usada agora
+            return true;
+        }
+    }
+
+    // Só numa falha da cache se constroem as ligações (em pipeline, sobrepostas às secções)
+    bool exportados;
+    if (pipeline) {
+        exportados = ExportarResultadosEmPipeline(grafo, nome_ficheiro);
+    } else if (!ConstruirLigacoes(grafo)) {
+        fprintf(stderr, "Erro ao construir as ligações entre antenas\n");
+        exportados = false;
+    } else {
+        exportados = ExportarResultados(*grafo, nome_ficheiro);
+    }
+    if (!exportados) return false;  // Resultados incompletos nunca entram na cache
+    if (!pasta_cache) return true;
+
+#ifdef _WIN32
+    _mkdir(pasta_cache);
+#else
+    mkdir(pasta_cache, 0755);
+#endif
+
+    // Escreve para um ficheiro temporário e renomeia, para nunca deixar entradas incompletas
+    char temporario[1100];
+    snprintf(temporario, sizeof(temporario), "%s.tmp", caminho);
+    if (CopiarFicheiro(nome_ficheiro, temporario)) {
+        remove(caminho);
+        if (rename(temporario, caminho) != 0) remove(temporario);
+        LimitarCache(pasta_cache, CACHE_LIMITE_BYTES);
+    } else {
+        remove(temporario);
+    }
+    return true;  // Uma falha ao guardar na cache não invalida os resultados
+}
+
 /**
  * @brief Liberta toda a memória alocada pelo grafo
  * @param grafo Apontador para o grafo
@@ -363,7 +2452,7 @@ bool LibertarGrafo(Grafo* grafo) {
         while (adj) {
             Adjacencia* temp = adj;
             adj = adj->proxima;
-            free(temp);
+            if (!temp->em_bloco) free(temp);
         }
         
         Antena* temp = atual;
@@ -371,8 +2460,15 @@ bool LibertarGrafo(Grafo* grafo) {
         free(temp);
     }
     
+    while (grafo->blocos_ligacoes) {
+        BlocoLigacoes* bloco = grafo->blocos_ligacoes;
+        grafo->blocos_ligacoes = bloco->proximo;
+        free(bloco);
+    }
+    
     grafo->antenas = NULL;
     grafo->total_antenas = 0;
+    LibertarDicionario(&grafo->frequencias);
     return true;
 }
 
@@ -11,6 +11,25 @@
 #include <stdbool.h>
 #include <string.h>
 #include <math.h>
+#include <pthread.h>
+
+#define TAMANHO_MAXIMO_ROTULO 32    ///< Número máximo de bytes no rótulo de uma frequência
+#define MARCADOR_ESTENDIDO "estendido"  ///< Palavra no cabeçalho que ativa o formato por tokens
+
+#define MAXIMO_TRABALHADORES 64 ///< Limite de threads usadas por uma operação paralela
+#define LIMIAR_DIVISAO_GRUPO 4096   ///< Ligações a partir das quais um grupo é dividido por várias threads
+
+#define TAREFAS_POR_TRABALHADOR 8   ///< Tarefas mínimas por thread na enumeração paralela de caminhos
+#define PROFUNDIDADE_MAXIMA_DIVISAO 8   ///< Profundidade máxima a que a árvore de caminhos é dividida
+#define BLOCO_TEXTO_CAMINHOS 65536  ///< Bytes de caminhos que uma tarefa acumula antes de os entregar
+#define LIMITE_MEMORIA_CAMINHOS (256L * 1024 * 1024)   ///< Bytes de caminhos à espera de escrita antes de passar a só contar
+
+#define TAMANHO_BLOCO 256       ///< Antenas por bloco no carregamento em pipeline
+#define CAPACIDADE_FILA 8       ///< Blocos que a fila do carregamento em pipeline pode conter
+
+#define PASTA_CACHE ".cache_resultados"                 ///< Pasta onde são guardados os resultados em cache
+#define CACHE_LIMITE_BYTES (64L * 1024 * 1024)          ///< Tamanho máximo da cache antes de remover entradas
+#define VERSAO_ANALISE 3                                ///< Versão das análises, incluída na chave da cache
 
 /**
  * @brief Estrutura que representa uma ligação entre antenas
@@ -18,17 +37,29 @@
 typedef struct Adjacencia {
     struct Antena* destino;     ///< Apontador para a antena de destino
     struct Adjacencia* proxima; ///< Apontador para a próxima adjacência na lista
+    bool em_bloco;              ///< Indica se pertence a um BlocoLigacoes (não é libertada sozinha)
 } Adjacencia;
 
+/**
+ * @brief Bloco de ligações alocadas de uma só vez na construção do grafo
+ */
+typedef struct BlocoLigacoes {
+    struct BlocoLigacoes* proximo;  ///< Próximo bloco do grafo
+    int usadas;                     ///< Ligações já atribuídas
+    int capacidade;                 ///< Ligações que o bloco comporta
+    Adjacencia ligacoes[];          ///< Ligações do bloco
+} BlocoLigacoes;
+
 /**
  * @brief Estrutura que representa uma antena na rede
  */
 typedef struct Antena {
-    char frequencia;            ///< Frequência de operação da antena (carácter único)
+    int frequencia;             ///< Identificador da frequência no dicionário do grafo
     int coluna;                 ///< Posição horizontal na matriz (coordenada X)
     int linha;                  ///< Posição vertical na matriz (coordenada Y)
     Adjacencia* ligacoes;       ///< Lista de ligações a outras antenas
     bool visitada;              ///< Indicador se a antena foi visitada em algoritmos de travessia
+    int indice;                 ///< Ordem de inserção da antena no grafo (0 a total_antenas-1)
     struct Antena* proxima;     ///< Apontador para a próxima antena na lista do grafo
 } Antena;
 
@@ -48,14 +79,93 @@ typedef struct FilaNode {
     struct FilaNode* proxima;    ///< Ponteiro para o próximo nó da fila
 } FilaNode;
 
+/**
+ * @brief Dicionário que associa rótulos de frequência a identificadores densos (0, 1, 2, ...)
+ */
+typedef struct DicionarioFrequencias {
+    char** rotulos;             ///< Rótulo de cada frequência, indexado pelo identificador
+    int total;                  ///< Número de frequências registadas
+    int capacidade;             ///< Posições alocadas em rotulos
+    int* tabela;                ///< Tabela de dispersão rótulo -> identificador (-1 se livre)
+    int capacidade_tabela;      ///< Tamanho da tabela (potência de 2)
+} DicionarioFrequencias;
+
 /**
  * @brief Estrutura principal que representa o grafo de antenas
  */
 typedef struct Grafo {
     Antena* antenas;            ///< Apontador para a primeira antena do grafo
     int total_antenas;          ///< Número total de antenas no grafo
+    int linhas;                 ///< Número de linhas da grelha lida
+    int colunas;                ///< Número de colunas da grelha lida
+    BlocoLigacoes* blocos_ligacoes; ///< Blocos onde estão as ligações criadas por ConstruirLigacoes
+    bool com_ligacoes;          ///< Indica se as ligações entre antenas já foram construídas
+    DicionarioFrequencias frequencias; ///< Rótulos das frequências usadas pelas antenas
 } Grafo;
 
+/**
+ * @brief Mapa de calor das interferências, com tabelas de somas acumuladas para consultas por região
+ * @note Existem total_frequencias + 1 camadas: uma por frequência e, na última, o total.
+ *       A camada do total existe sempre; a de uma frequência só é alocada se o mapa
+ *       for calculado por frequência e essa frequência tiver interferências na grelha
+ */
+typedef struct MapaCalor {
+    int linhas;                 ///< Número de linhas da grelha
+    int colunas;                ///< Número de colunas da grelha
+    int total_frequencias;      ///< Número de frequências (camadas antes da do total)
+    bool por_frequencia;        ///< Indica se as camadas de cada frequência foram calculadas
+    unsigned int** contagens;   ///< Interferências por célula de cada camada (linhas * colunas), ou NULL se vazia
+    long long** somas;          ///< Somas acumuladas de cada camada ((linhas + 1) * (colunas + 1)), ou NULL se vazia
+} MapaCalor;
+
+/**
+ * @brief Estrutura que agrupa as antenas de uma mesma frequência
+ */
+typedef struct GrupoFrequencia {
+    int frequencia;             ///< Frequência comum a todas as antenas do grupo
+    Antena** antenas;           ///< Vetor com as antenas do grupo, pela ordem da lista do grafo
+    int total;                  ///< Número de antenas no grupo
+} GrupoFrequencia;
+
+/**
+ * @brief Obtém o número de threads a usar nas operações paralelas
+ * @return Número de processadores disponíveis, entre 1 e MAXIMO_TRABALHADORES
+ */
+int NumeroTrabalhadores(void);
+
+/**
+ * @brief Obtém o identificador de uma frequência, registando-a se for nova
+ * @param dicionario Apontador para o dicionário de frequências
+ * @param rotulo Bytes do rótulo (não precisa de terminar em '\0')
+ * @param tamanho Número de bytes do rótulo (1 a TAMANHO_MAXIMO_ROTULO)
+ * @return Identificador da frequência, ou -1 em caso de erro
+ */
+int RegistarFrequencia(DicionarioFrequencias* dicionario, const char* rotulo, size_t tamanho);
+
+/**
+ * @brief Procura o identificador de uma frequência sem a registar
+ * @param dicionario Apontador para o dicionário de frequências
+ * @param rotulo Bytes do rótulo
+ * @param tamanho Número de bytes do rótulo
+ * @return Identificador da frequência, ou -1 se não existir
+ */
+int ProcurarFrequencia(const DicionarioFrequencias* dicionario, const char* rotulo, size_t tamanho);
+
+/**
+ * @brief Obtém o rótulo de uma frequência
+ * @param grafo Apontador para o grafo
+ * @param frequencia Identificador da frequência
+ * @return Rótulo terminado em '\0', ou "?" se o identificador for inválido
+ */
+const char* RotuloFrequencia(const Grafo* grafo, int frequencia);
+
+/**
+ * @brief Liberta a memória de um dicionário de frequências
+ * @param dicionario Apontador para o dicionário a ser libertado
+ * @return Verdadeiro se a operação foi concluída com sucesso, falso caso contrário
+ */
+bool LibertarDicionario(DicionarioFrequencias* dicionario);
+
 /**
  * @brief Adiciona uma ligação entre duas antenas
  * @param origem Apontador para a antena de origem
@@ -67,12 +177,19 @@ bool AdicionarAdjacencia(Antena* origem, Antena* destino);
 /**
  * @brief Adiciona uma nova antena ao grafo
  * @param grafo Apontador para o grafo onde será adicionada a antena
- * @param freq Frequência da nova antena
+ * @param freq Identificador da frequência da nova antena (ver RegistarFrequencia)
  * @param col Posição horizontal da antena
  * @param lin Posição vertical da antena
  * @return Verdadeiro se a antena foi adicionada com sucesso, falso caso contrário
  */
-bool AdicionarAntena(Grafo* grafo, char freq, int col, int lin);
+bool AdicionarAntena(Grafo* grafo, int freq, int col, int lin);
+
+/**
+ * @brief Lê as antenas de um ficheiro de texto, sem construir as ligações
+ * @param nome_ficheiro Nome do ficheiro contendo os dados das antenas
+ * @return Estrutura Grafo com as antenas (com_ligacoes a falso)
+ */
+Grafo LerAntenasDoFicheiro(const char* nome_ficheiro);
 
 /**
  * @brief Carrega as antenas a partir de um ficheiro de texto
@@ -81,6 +198,38 @@ bool AdicionarAntena(Grafo* grafo, char freq, int col, int lin);
  */
 Grafo CarregarAntenasDoFicheiro(const char* nome_ficheiro);
 
+/**
+ * @brief Lê as antenas de um ficheiro, sobrepondo a leitura e a inserção no grafo
+ * @param nome_ficheiro Nome do ficheiro contendo os dados das antenas
+ * @return Estrutura Grafo igual à devolvida por LerAntenasDoFicheiro (sem ligações)
+ */
+Grafo LerAntenasEmPipeline(const char* nome_ficheiro);
+
+/**
+ * @brief Agrupa as antenas do grafo por frequência
+ * @param grafo Apontador para o grafo a ser agrupado
+ * @param total_grupos Apontador onde será guardado o número de grupos criados
+ * @return Vetor com um grupo por frequência, indexado pelo identificador (grupos vazios incluídos),
+ *         ou NULL em caso de erro ou grafo vazio
+ */
+GrupoFrequencia* AgruparPorFrequencia(Grafo* grafo, int* total_grupos);
+
+/**
+ * @brief Liberta a memória de um vetor de grupos de frequência
+ * @param grupos Vetor de grupos a ser libertado
+ * @param total_grupos Número de grupos no vetor
+ * @return Verdadeiro se a operação foi concluída com sucesso, falso caso contrário
+ */
+bool LibertarGrupos(GrupoFrequencia* grupos, int total_grupos);
+
+/**
+ * @brief Cria as ligações entre antenas da mesma frequência, em paralelo por grupo
+ * @param grafo Apontador para o grafo cujas ligações serão construídas
+ * @return Verdadeiro se a operação foi concluída com sucesso, falso caso contrário
+ * @note Não faz nada se grafo->com_ligacoes já for verdadeiro
+ */
+bool ConstruirLigacoes(Grafo* grafo);
+
 /**
  * @brief Realiza uma travessia em profundidade (DFS) no grafo
  * @param grafo Apontador para o grafo a ser percorrido
@@ -109,6 +258,19 @@ bool ProcuraEmLargura(Grafo* grafo, Antena* inicio, FILE* saida);
  */
 bool EncontrarCaminhos(Grafo* grafo, Antena* origem, Antena* destino, FILE* saida);
 
+/**
+ * @brief Encontra todos os caminhos entre duas antenas, dividindo a procura por várias threads
+ * @param grafo Apontador para o grafo a ser analisado
+ * @param origem Apontador para a antena de origem
+ * @param destino Apontador para a antena de destino
+ * @param saida Ficheiro onde serão escritos os caminhos (NULL para apenas os contar)
+ * @param total_caminhos Apontador onde será guardado o número de caminhos (pode ser NULL)
+ * @return Verdadeiro se a operação foi concluída com sucesso, falso caso contrário
+ * @note Se os caminhos à espera de escrita excederem LIMITE_MEMORIA_CAMINHOS, a
+ *       listagem é interrompida (sempre em linhas completas) e os restantes só contados
+ */
+bool EncontrarCaminhosParalelo(Grafo* grafo, Antena* origem, Antena* destino, FILE* saida, long long* total_caminhos);
+
 /**
  * @brief Mostra intersecções entre antenas de frequências diferentes
  * @param grafo Apontador para o grafo a ser analisado
@@ -117,7 +279,7 @@ bool EncontrarCaminhos(Grafo* grafo, Antena* origem, Antena* destino, FILE* said
  * @param saida Ficheiro onde serão escritos os resultados
  * @return Verdadeiro se a operação foi concluída com sucesso, falso caso contrário
  */
-bool MostrarIntersecoes(Grafo* grafo, char freqA, char freqB, FILE* saida);
+bool MostrarIntersecoes(Grafo* grafo, int freqA, int freqB, FILE* saida);
 
 /**
  * @brief Calcula pontos de interferência entre antenas
@@ -127,6 +289,76 @@ bool MostrarIntersecoes(Grafo* grafo, char freqA, char freqB, FILE* saida);
  */
 bool CalcularInterferencias(Grafo* grafo, FILE* saida);
 
+/**
+ * @brief Calcula o mapa de calor dos pontos de interferência entre pares de antenas distintas
+ * @param grafo Apontador para o grafo a ser analisado
+ * @param por_frequencia Se verdadeiro, calcula também uma camada por frequência;
+ *        se falso, só a camada do total
+ * @param mapa Apontador para o mapa a preencher (libertar com LibertarMapaCalor)
+ * @return Verdadeiro se a operação foi concluída com sucesso, falso caso contrário
+ */
+bool CalcularMapaCalor(Grafo* grafo, bool por_frequencia, MapaCalor* mapa);
+
+/**
+ * @brief Conta as interferências num retângulo da grelha, em tempo constante
+ * @param mapa Apontador para o mapa de calor
+ * @param frequencia Identificador da frequência (exige um mapa calculado por frequência),
+ *        ou -1 para todas
+ * @param col_min Primeira coluna do retângulo
+ * @param lin_min Primeira linha do retângulo
+ * @param col_max Última coluna do retângulo (inclusive)
+ * @param lin_max Última linha do retângulo (inclusive)
+ * @return Número de interferências no retângulo (0 se for vazio ou inválido)
+ */
+long long ContarInterferenciasRegiao(const MapaCalor* mapa, int frequencia,
+                                     int col_min, int lin_min, int col_max, int lin_max);
+
+/**
+ * @brief Calcula a densidade de interferências (por célula) num retângulo da grelha
+ * @param mapa Apontador para o mapa de calor
+ * @param frequencia Identificador da frequência, ou -1 para todas
+ * @param col_min Primeira coluna do retângulo
+ * @param lin_min Primeira linha do retângulo
+ * @param col_max Última coluna do retângulo (inclusive)
+ * @param lin_max Última linha do retângulo (inclusive)
+ * @return Interferências a dividir pelo número de células do retângulo dentro da grelha
+ */
+double DensidadeInterferenciasRegiao(const MapaCalor* mapa, int frequencia,
+                                     int col_min, int lin_min, int col_max, int lin_max);
+
+/**
+ * @brief Exporta uma camada do mapa de calor como imagem PGM binária (P5)
+ * @param mapa Apontador para o mapa de calor
+ * @param frequencia Identificador da frequência (exige um mapa calculado por frequência),
+ *        ou -1 para o total
+ * @param nome_ficheiro Nome do ficheiro de saída
+ * @return Verdadeiro se a operação foi concluída com sucesso, falso caso contrário
+ */
+bool ExportarMapaCalorPGM(const MapaCalor* mapa, int frequencia, const char* nome_ficheiro);
+
+/**
+ * @brief Exporta as camadas de contagens calculadas do mapa de calor num ficheiro binário
+ * @param mapa Apontador para o mapa de calor
+ * @param nome_ficheiro Nome do ficheiro de saída
+ * @return Verdadeiro se a operação foi concluída com sucesso, falso caso contrário
+ */
+bool ExportarMapaCalorBinario(const MapaCalor* mapa, const char* nome_ficheiro);
+
+/**
+ * @brief Liberta a memória de um mapa de calor
+ * @param mapa Apontador para o mapa a ser libertado
+ * @return Verdadeiro se a operação foi concluída com sucesso, falso caso contrário
+ */
+bool LibertarMapaCalor(MapaCalor* mapa);
+
+/**
+ * @brief Deteta conjuntos de três ou mais antenas da mesma frequência alinhadas
+ * @param grafo Apontador para o grafo a ser analisado
+ * @param saida Ficheiro onde serão escritos os resultados
+ * @return Verdadeiro se a operação foi concluída com sucesso, falso caso contrário
+ */
+bool CalcularColineares(Grafo* grafo, FILE* saida);
+
 /**
  * @brief Exporta todos os resultados para um ficheiro
  * @param grafo Grafo a ser analisado
@@ -135,6 +367,32 @@ bool CalcularInterferencias(Grafo* grafo, FILE* saida);
  */
 bool ExportarResultados(Grafo grafo, const char* nome_ficheiro);
 
+/**
+ * @brief Exporta todos os resultados, calculando as secções em paralelo e escrevendo-as por ordem
+ * @param grafo Grafo a ser analisado; se ainda não tiver ligações, são construídas
+ *        em simultâneo com as secções que não as usam
+ * @param nome_ficheiro Nome do ficheiro de saída
+ * @return Verdadeiro se a operação foi concluída com sucesso, falso caso contrário
+ */
+bool ExportarResultadosEmPipeline(Grafo* grafo, const char* nome_ficheiro);
+
+/**
+ * @brief Calcula a chave da cache de resultados para um grafo
+ * @param grafo Apontador para o grafo
+ * @return Valor de dispersão (FNV-1a de 64 bits) das antenas e das opções de análise
+ */
+unsigned long long CalcularChaveCache(Grafo* grafo);
+
+/**
+ * @brief Exporta os resultados, reutilizando-os da cache em disco quando possível
+ * @param grafo Grafo a ser analisado; as ligações só são construídas se a cache falhar
+ * @param nome_ficheiro Nome do ficheiro de saída
+ * @param pasta_cache Pasta onde estão guardadas as entradas da cache
+ * @param pipeline Se verdadeiro, os resultados em falta são calculados em pipeline
+ * @return Verdadeiro se a operação foi concluída com sucesso, falso caso contrário
+ */
+bool ExportarResultadosComCache(Grafo* grafo, const char* nome_ficheiro, const char* pasta_cache, bool pipeline);
+
 /**
  * @brief Liberta toda a memória alocada para o grafo
  * @param grafo Apontador para o grafo a ser libertado
@@ -11,12 +11,22 @@
  * @brief Função principal do programa
  * @return 0 se o programa foi executado com sucesso, 1 caso ocorra algum erro
  * 
+ * @param argc Número de argumentos
+ * @param argv Argumentos; "--pipeline" sobrepõe leitura, análise e escrita
+ * 
  * @note O programa espera um ficheiro de entrada chamado "antenas.txt"
- *       e gera um ficheiro de saída chamado "resultado.txt"
+ *       e gera os ficheiros de saída "resultado.txt" e "mapa_calor.pgm"
  */
-int main() {
-    // Carregar a rede de antenas do ficheiro
-    Grafo grafo = CarregarAntenasDoFicheiro("antenas.txt");
+int main(int argc, char* argv[]) {
+    bool pipeline = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--pipeline") == 0) pipeline = true;
+    }
+
+    // Carregar a rede de antenas do ficheiro; as ligações só são construídas
+    // se os resultados não estiverem na cache
+    Grafo grafo = pipeline ? LerAntenasEmPipeline("antenas.txt")
+                           : LerAntenasDoFicheiro("antenas.txt");
     
     // Verificar se o carregamento foi bem sucedido
     if (grafo.total_antenas == 0) {
@@ -24,13 +34,24 @@ int main() {
         return 1;
     }
     
-    // Exportar os resultados das análises
-    if (!ExportarResultados(grafo, "resultado.txt")) {
+    // Exportar os resultados das análises, reutilizando a cache se o mapa não mudou
+    if (!ExportarResultadosComCache(&grafo, "resultado.txt", PASTA_CACHE, pipeline)) {
         fprintf(stderr, "Erro ao exportar resultados.\n");
         LibertarGrafo(&grafo);
         return 1;
     }
     
+    // Exportar o mapa de calor das interferências (só a camada do total)
+    MapaCalor mapa;
+    if (!CalcularMapaCalor(&grafo, false, &mapa)) {
+        fprintf(stderr, "Erro ao calcular mapa de calor.\n");
+    } else {
+        if (!ExportarMapaCalorPGM(&mapa, -1, "mapa_calor.pgm")) {
+            fprintf(stderr, "Erro ao exportar mapa de calor.\n");
+        }
+        LibertarMapaCalor(&mapa);
+    }
+    
     // Libertar a memória alocada
     LibertarGrafo(&grafo);
     return 0;